@@ -2,38 +2,317 @@
  * File: Program2.c
  *Author: Prashant Yadav
  *Procedure:
- *read - Each reader thread starts execution from this routine.
- *write - Each writer thread starts execution from this routine.
+ *read_routine - Each reader thread starts execution from this routine.
+ *write_routine - Each writer thread starts execution from this routine.
  *writerarray - Write routine calls this routine to write data to shared array.
  *readarray - Read routine calls this routine to read data from shared array.
- *main - Main routine from where program starts executing.In this routine we initialize 10 reader 
- *       threads and 1 writer thread.
+ *lock_pause - Backs off inside a spin loop of the ticket and phase fair locks.
+ *futex_wait - Sleeps on the futex lock word while it holds an expected value.
+ *futex_wake - Wakes all threads sleeping on the futex lock word.
+ *reader_lock - Acquires the reader side of the selected lock.
+ *reader_unlock - Releases the reader side of the selected lock.
+ *writer_lock - Acquires the writer side of the selected lock.
+ *writer_unlock - Releases the writer side of the selected lock.
+ *now_ns - Returns monotonic time in nanoseconds.
+ *record_wait - Adds one lock acquisition to the stats of a thread.
+ *print_lock_stats - Prints throughput, acquisitions and wait time histograms.
+ *open_miss_counter - Opens a perf_event cache miss counter for this process and its threads.
+ *fs_worker - Each thread of the false sharing microbenchmark starts execution from this routine.
+ *false_sharing_benchmark - Compares packed, padded and thread local counters across thread counts.
+ *mix_worker - Each thread of the read write mix benchmark starts execution from this routine.
+ *mix_benchmark - Compares all locks on a read write mix across thread counts.
+ *deque_push - Owner pushes a chunk of work at bottom of its work stealing deque.
+ *deque_take - Owner takes a chunk of work from bottom of its deque.
+ *deque_steal - Another reader steals a chunk of work from top of a deque.
+ *partition_writer - Each writer of the partitioned buffer starts execution from this routine.
+ *refill_deque - Moves written values of partitions of a reader into its deque.
+ *stealing_reader - Each reader of the partitioned buffer starts execution from this routine.
+ *partitioned_run - Runs writers and work stealing readers on the partitioned buffer.
+ *parse_arguments - Parses command line options.
+ *main - Main routine from where program starts executing.In this routine we initialize reader 
+ *       threads (10 by default) and 1 writer thread.
  *******************************************************************/
 #include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<limits.h>
+#include<time.h>
+#include<unistd.h>
+#include<sched.h>
 #include<pthread.h>
 #include<semaphore.h>
+#include<sys/ioctl.h>
+#include<sys/syscall.h>
+#include<linux/futex.h>
+#include<linux/perf_event.h>
+#include "../common/prng.h"
+
+#define CACHE_LINE 64  //Variables written by different threads are kept on separate cache lines.
+#define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE)))
+#define MAX_READERS 64
 
 int  MAX =  1000000;   //Max size of Shared array.
-int sharedarr[1000000], start=0, end=0, readerdata[10];  //Initialize shared array.
-int readercount, writercount, counter=0;  //These variables are used to mantain read and write count.
-sem_t x, y,z, wsem, rsem;  //Declaration of useful semaphores.
-void readarray();  //Declaration of readarray routine
+int *sharedarr;        //Shared array.
+int bench_mode=0;      //1 to suppress per value output and print operation count at end
+uint64_t seed;         //Seed of random number streams of mix benchmark and stealing readers
+int readers=10;        //Number of reader threads.
+int start CACHE_ALIGNED=0;             //Next position to read, readers claim it with CAS.
+int end CACHE_ALIGNED=0, counter=0;    //Next position and value to write, only writer changes them.
+int readercount CACHE_ALIGNED;  //These variables are used to mantain read and write count.
+int writercount CACHE_ALIGNED;
+sem_t x CACHE_ALIGNED, y CACHE_ALIGNED, z CACHE_ALIGNED, wsem CACHE_ALIGNED, rsem CACHE_ALIGNED;  //Declaration of useful semaphores.
+int readarray();  //Declaration of readarray routine
 void writerarray();  //Declaration of writerarray routine
 
+#define LOCK_READER 0   //Reader preference, semaphores x and wsem.
+#define LOCK_WRITER 1   //Writer preference, all five semaphores.
+#define LOCK_TICKET 2   //Task fair, readers and writers are admitted in ticket order.
+#define LOCK_PHASE  3   //Phase fair, reader and writer phases alternate.
+#define LOCK_FUTEX  4   //One atomic word, waiters sleep in the kernel.
+#define LOCK_BRLOCK 5   //Big reader lock, every reader has its own slot.
+#define LOCKS 6
+const char *lock_names[LOCKS]={"reader","writer","ticket","phase","futex","brlock"};
+int lock_kind=LOCK_WRITER;  //Lock selected with --lock.
+
+unsigned int ticket_next CACHE_ALIGNED=0, ticket_serving=0;  //Ticket lock state.
+unsigned int ticket_readers CACHE_ALIGNED=0;
+
+#define PF_RINC  0x100  //Reader increment of pf_rin and pf_rout.
+#define PF_WBITS 0x3    //Writer bits of pf_rin.
+#define PF_PRES  0x2    //Writer present.
+#define PF_PHID  0x1    //Phase id of present writer.
+unsigned int pf_rin CACHE_ALIGNED=0, pf_rout=0;  //Phase fair lock state of readers.
+unsigned int pf_win CACHE_ALIGNED=0, pf_wout=0;  //Phase fair lock state of writers.
+
+#define WORD_WAITERS 0x40000000  //Some thread sleeps on futex_word.
+#define WORD_WRITER  0x20000000  //Writer holds the lock.
+#define WORD_PENDING 0x10000000  //Writer waits, new readers have to wait too.
+#define WORD_READERS 0x0fffffff  //Number of readers holding the lock.
+int futex_word CACHE_ALIGNED=0;  //Futex lock state.
+
+//Big reader lock state. A reader marks only its own slot, so read acquisitions of different
+//readers write different cache lines, the writer scans all slots to wait for readers to leave.
+struct br_slot{
+ int active;                    //1 while the reader holds or is taking the lock.
+} CACHE_ALIGNED br_slots[MAX_READERS];
+int br_writer CACHE_ALIGNED=0;  //1 while a writer holds or is taking the lock.
+__thread int reader_slot=0;     //Slot of the calling reader thread.
+
+#define WAIT_BUCKETS 40  //Bucket b counts waits shorter than 2^b ns and at least 2^(b-1) ns.
+struct lock_stats{
+ long long acquisitions;       //Times the thread acquired the lock.
+ long long wait_ns;            //Total time spent waiting for the lock.
+ long long max_wait_ns;        //Longest single wait.
+ long long hist[WAIT_BUCKETS]; //Wait time histogram.
+};
+//Results of one reader, each on its own cache lines. Reader counts in local variables and stores
+//them here when it finishes, main merges them after join.
+struct reader_state{
+ long long reads;           //Values read by the reader.
+ struct lock_stats stats;   //Lock acquisitions of the reader.
+} CACHE_ALIGNED;
+struct reader_state reader_states[MAX_READERS];
+struct lock_stats writer_stats;  //Lock stats of the writer.
+
+int fs_mode=0;                    //1 to run false sharing microbenchmark instead of readers and writer.
+long long fs_iterations=1000000;  //Increments of its counter done by each microbenchmark thread.
+#define FS_LAYOUTS 3
+const char *fs_layout_names[FS_LAYOUTS]={"packed","padded","local"};
+int fs_layout;                    //Layout measured by running microbenchmark threads.
+long long fs_packed[MAX_READERS]; //Adjacent counters, as readerdata used to be.
+struct padded_counter{
+ long long value;
+} CACHE_ALIGNED fs_padded[MAX_READERS];  //One counter per cache line.
+
+double mix_write_ratio=-1;        //Share of writes in read write mix benchmark, below 0 not run.
+long long mix_ops=20000;          //Lock acquisitions of each mix benchmark thread.
+#define MIX_WORDS 16
+int mix_data[MIX_WORDS] CACHE_ALIGNED;  //Writers increment every word, readers see them all equal.
+struct mix_state{
+ long long reads, writes;
+ struct lock_stats read_stats, write_stats;
+} CACHE_ALIGNED mix_states[MAX_READERS];
+
+//Partitioned buffer. Writer w fills its own partition of sharedarr, reader w%readers owns it and
+//moves what is written into its work stealing deque in chunks, readers with nothing left in
+//their own deque steal chunks from others. No lock is taken.
+#define MAX_WRITERS 64
+#define CHUNK 64          //Most values in a chunk of work.
+#define DEQUE_SIZE 1024   //Chunks a deque holds, power of 2.
+int writers=0;            //Writers of partitioned buffer, 0 runs one writer with the selected lock.
+struct partition{
+ int base, size;          //Positions of sharedarr in the partition.
+ int written CACHE_ALIGNED;  //Values written so far, only the writer changes it.
+ int taken CACHE_ALIGNED;    //Values moved into the deque of owner, only the owner changes it.
+} CACHE_ALIGNED partitions[MAX_WRITERS];
+//Chase-Lev deque of chunks, a chunk is its first position in high 32 bits and length in low ones.
+//Owner pushes and takes at bottom, thieves steal at top.
+struct deque{
+ long long top CACHE_ALIGNED;
+ long long bottom CACHE_ALIGNED;
+ unsigned long long tasks[DEQUE_SIZE];
+} CACHE_ALIGNED deques[MAX_READERS];
+struct steal_state{
+ long long steals, attempts, refills;  //Chunks stolen, steal attempts and deque refills.
+} CACHE_ALIGNED steal_states[MAX_READERS];
+int remaining CACHE_ALIGNED;  //Values not read yet.
+
+static inline void lock_pause(int *spins);
+void reader_lock();
+void reader_unlock();
+void writer_lock();
+void writer_unlock();
+long long now_ns();
+void record_wait(struct lock_stats *stats, long long ns);
+
 /*******************************************************************
- *void* read(void *id)
+ *void* read_routine(void *id)
  *Author: Prashant Yadav
  *Date: 9/29/2019
  *Description: It check whether there is a writer thread currently accessing shared array.If yes it 
  *             waits for writer to finish, otherwise holds a lock on shared array to read data from it.
- *             it allows multiple readers to read from the shared array.
+ *             it allows multiple readers to read from the shared array. Time spent in reader_lock
+ *             and values read are counted locally and stored to reader_states at exit. When nothing
+ *             is left to read the reader waits for the writer outside the lock, otherwise readers
+ *             taking the lock over and over keep the writer out.
  *Parameters:
  *id I/P int This is used as a thread id to identify each reader thread.
  *This routine does not return anything.
  *******************************************************************/
-void*  read(void *id)
+void*  read_routine(void *id)
 {
+ struct lock_stats stats;
+ long long reads=0;
+ memset(&stats, 0, sizeof(stats));
+ reader_slot=(int)(long)id-1;  //Reader ids start at 1.
  while(1){
+  long long begin=now_ns();
+  reader_lock();       //Enter critical section shared with other readers.
+  record_wait(&stats, now_ns()-begin);
+  int got=readarray(id);  //Call to readarray routine.
+  reads+=got;
+  reader_unlock();     //Exit critical section.
+  if(__atomic_load_n(&start, __ATOMIC_ACQUIRE)==MAX){  //If start reaches to end of shared array exit from while loop.
+   if(!bench_mode){
+    printf("\n Reader finshed..");
+   }
+   break;
+  }
+  if(!got){            //Wait until writer writes a value not read yet.
+   int spins=0, pos;
+   while((pos=__atomic_load_n(&start, __ATOMIC_ACQUIRE))<MAX && __atomic_load_n(&end, __ATOMIC_ACQUIRE)<=pos){
+    lock_pause(&spins);
+   }
+  }
+ }
+ reader_states[(int)(long)id-1].reads=reads;  //Publish local counters once, main reads them after join.
+ reader_states[(int)(long)id-1].stats=stats;
+ return NULL;
+}
+
+/*******************************************************************
+ *void* write_routine()
+ *Author: Prashant Yadav
+ *Date: 9/29/2019
+ *Description: It checks if there are any reader thread currently reading from shared array.If yes
+ *             writer thread wait for reader thread to finish, otherwise writer thread holds lock
+ *             on shared array and starts writing to it. Time spent in writer_lock is recorded in
+ *             writer_stats.
+ *Parameters:
+ *There are no Input args to this routine.
+ *This routine does not return anything.
+ *******************************************************************/
+void* write_routine()
+{
+ while(1){
+  long long begin=now_ns();
+  writer_lock();       //Enter critical section alone.
+  record_wait(&writer_stats, now_ns()-begin);
+  writerarray();       //Call to writerarray routine.
+  int done=end==MAX;   //Writer finshed writing to shared array.
+  writer_unlock();     //Exit critical section.
+  if(done){            //Gracefully exit from while loop.
+   if(!bench_mode){
+    printf("\n Writer finished...");
+   }
+   break;
+  }
+ }
+ return NULL;
+}
+
+/*******************************************************************
+ *void lock_pause(int *spins)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It is called in every iteration of a spin loop. First iterations only relax the
+ *             processor, later ones yield it, so a lock holder that is not running can finish.
+ *Parameters:
+ *int *spins I/P: Iterations spent in the loop so far, incremented here.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void lock_pause(int *spins){
+ if(++*spins<64){
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+ }else{
+  sched_yield();
+ }
+}
+
+/*******************************************************************
+ *void futex_wait(int *addr, int val)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It sleeps until woken if *addr still equals val, otherwise returns at once.
+ *Parameters:
+ *int *addr I/P: Futex word.
+ *int val I/P: Value the caller saw in the futex word.
+ *This routine does not return anything.
+ *******************************************************************/
+void futex_wait(int *addr, int val){
+ syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+/*******************************************************************
+ *void futex_wake(int *addr)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It wakes every thread sleeping on the futex word.
+ *Parameters:
+ *int *addr I/P: Futex word.
+ *This routine does not return anything.
+ *******************************************************************/
+void futex_wake(int *addr){
+ syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+/*******************************************************************
+ *void reader_lock()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It acquires the selected lock for reading.
+ *             reader - first reader locks out the writer through wsem, later readers enter while
+ *                      any reader is inside, so writer can starve.
+ *             writer - readers queue on z and rsem, writer holds rsem while it wants to write, so
+ *                      readers can starve.
+ *             ticket - reader takes a ticket, waits for its turn and passes turn on at once, so
+ *                      following readers join it but nobody overtakes an earlier writer.
+ *             phase  - reader waits only for the writer present when it arrived, so it waits at
+ *                      most one writer phase.
+ *             futex  - reader increments the reader count of futex_word unless writer holds or
+ *                      waits for the lock, in which case it sleeps on futex_word.
+ *             brlock - reader sets its own slot and enters unless a writer is there, then it
+ *                      clears the slot again and waits for the writer to leave.
+ *Parameters:
+ *There are no input args to this routine.
+ *This routine does not return anything.
+ *******************************************************************/
+void reader_lock(){
+ int spins=0;
+ switch(lock_kind){
+ case LOCK_WRITER:
   sem_wait(&z);        //Reduce value of semaphore z by 1.
   sem_wait(&rsem);     //Reduce value of semaphore rsem by 1.
   sem_wait(&x);        //Reduce vlaue of semaphore x by 1.
@@ -44,34 +323,119 @@ void*  read(void *id)
   sem_post(&x);        //Singal x i.e increase value of sempahore x by 1.
   sem_post(&rsem);     //Signal rsem. It sllows multiple readers to enter critical section.
   sem_post(&z);        //Singal semaphore z. Increase value by 1. 
-  readarray(id);       //Call to readarray routine.
-  if(start==MAX){      //If start reaches to end of shared array exit from while loop.
-   printf("\n Reader finshed..");
-   break;
+  break;
+ case LOCK_READER:
+  sem_wait(&x);
+  readercount++;
+  if(readercount==1){
+   sem_wait(&wsem);
+  }
+  sem_post(&x);
+  break;
+ case LOCK_TICKET:{
+  unsigned int ticket=__atomic_fetch_add(&ticket_next, 1, __ATOMIC_RELAXED);
+  while(__atomic_load_n(&ticket_serving, __ATOMIC_ACQUIRE)!=ticket){
+   lock_pause(&spins);
+  }
+  __atomic_fetch_add(&ticket_readers, 1, __ATOMIC_SEQ_CST);  //Counted before next ticket is served.
+  __atomic_store_n(&ticket_serving, ticket+1, __ATOMIC_RELEASE);
+  break;
+ }
+ case LOCK_PHASE:{
+  unsigned int w=__atomic_fetch_add(&pf_rin, PF_RINC, __ATOMIC_ACQUIRE)&PF_WBITS;
+  if(w!=0){            //Wait until the present writer leaves, a later writer has other phase id.
+   while((__atomic_load_n(&pf_rin, __ATOMIC_ACQUIRE)&PF_WBITS)==w){
+    lock_pause(&spins);
+   }
+  }
+  break;
+ }
+ case LOCK_FUTEX:
+  while(1){
+   int s=__atomic_load_n(&futex_word, __ATOMIC_RELAXED);
+   if(!(s&(WORD_WRITER|WORD_PENDING))){
+    if(__atomic_compare_exchange_n(&futex_word, &s, s+1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)){
+     break;
+    }
+    continue;
+   }
+   if(!(s&WORD_WAITERS) && !__atomic_compare_exchange_n(&futex_word, &s, s|WORD_WAITERS, 0,
+                                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+    continue;
+   }
+   futex_wait(&futex_word, s|WORD_WAITERS);
+  }
+  break;
+ case LOCK_BRLOCK:{
+  struct br_slot *slot=&br_slots[reader_slot];
+  while(1){
+   __atomic_store_n(&slot->active, 1, __ATOMIC_SEQ_CST);  //Slot is set before writer is checked.
+   if(__atomic_load_n(&br_writer, __ATOMIC_SEQ_CST)==0){
+    break;
+   }
+   __atomic_store_n(&slot->active, 0, __ATOMIC_RELEASE);  //Let the writer drain, then retry.
+   while(__atomic_load_n(&br_writer, __ATOMIC_ACQUIRE)!=0){
+    lock_pause(&spins);
+   }
   }
+  break;
+ }
+ }
+}
+
+/*******************************************************************
+ *void reader_unlock()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It releases the selected lock held for reading. Last reader lets the writer in.
+ *Parameters:
+ *There are no input args to this routine.
+ *This routine does not return anything.
+ *******************************************************************/
+void reader_unlock(){
+ switch(lock_kind){
+ case LOCK_WRITER:
+ case LOCK_READER:
   sem_wait(&x);        //Hold lock on semaphore x to exit from the critical section.
   readercount--;       //Decrease readercount at exit of critical section.
   if(readercount==0){  //Condition to check if there are no readers signal to wsem semaphore.
    sem_post(&wsem);
   }
   sem_post(&x);        //Unlock sempahore x and exit critical section..
+  break;
+ case LOCK_TICKET:
+  __atomic_fetch_sub(&ticket_readers, 1, __ATOMIC_RELEASE);
+  break;
+ case LOCK_PHASE:
+  __atomic_fetch_add(&pf_rout, PF_RINC, __ATOMIC_RELEASE);
+  break;
+ case LOCK_FUTEX:{
+  int s=__atomic_sub_fetch(&futex_word, 1, __ATOMIC_RELEASE);
+  if((s&WORD_READERS)==0 && (s&WORD_WAITERS)){  //Waiting writer can go now.
+   __atomic_fetch_and(&futex_word, ~WORD_WAITERS, __ATOMIC_RELAXED);
+   futex_wake(&futex_word);
+  }
+  break;
+ }
+ case LOCK_BRLOCK:
+  __atomic_store_n(&br_slots[reader_slot].active, 0, __ATOMIC_RELEASE);
+  break;
  }
 }
 
 /*******************************************************************
- *void* write()
+ *void writer_lock()
  *Author: Prashant Yadav
- *Date: 9/29/2019
- *Description: It checks if there are any reader thread currently reading from shared array.If yes
- *             writer thread wait for reader thread to finish, otherwise writer thread holds lock
- *             on shared array and starts writing to it.
+ *Date: 10/19/2026
+ *Description: It acquires the selected lock for writing, see reader_lock for each lock.
  *Parameters:
- *There are no Input args to this routine.
+ *There are no input args to this routine.
  *This routine does not return anything.
  *******************************************************************/
-void* write()
-{
- while(1){
+void writer_lock(){
+ int spins=0;
+ switch(lock_kind){
+ case LOCK_WRITER:
   sem_wait(&y);        //Reduce value of semaphore by y.
   writercount++;       //Increase value of writercount by 1 at entry to critical section.
   if(writercount==1){  //If writercount=1 signal to rsem, i.e. wait for readers to exit.
@@ -79,13 +443,78 @@ void* write()
   }
   sem_post(&y);        //Increase value of semaphore by 1.
   sem_wait(&wsem);     //Reduce value of wsem by 1 at entry to critical section.
-  writerarray();       //Call to writerarray routine.
-  if(end==MAX){        //If writer finshed writing to shared array, gracefully exit from while loop.
-   printf("\n Writer finished...");
-   sem_post(&wsem);    //Before exiting signal wsem and rsem. To let readers to read.
-   sem_post(&rsem);
-   break;
+  break;
+ case LOCK_READER:
+  sem_wait(&wsem);
+  break;
+ case LOCK_TICKET:{
+  unsigned int ticket=__atomic_fetch_add(&ticket_next, 1, __ATOMIC_RELAXED);
+  while(__atomic_load_n(&ticket_serving, __ATOMIC_ACQUIRE)!=ticket){
+   lock_pause(&spins);
+  }
+  while(__atomic_load_n(&ticket_readers, __ATOMIC_SEQ_CST)!=0){  //Drain readers admitted earlier.
+   lock_pause(&spins);
+  }
+  break;
+ }
+ case LOCK_PHASE:{
+  unsigned int ticket=__atomic_fetch_add(&pf_win, 1, __ATOMIC_RELAXED);
+  while(__atomic_load_n(&pf_wout, __ATOMIC_ACQUIRE)!=ticket){
+   lock_pause(&spins);
+  }
+  //Block new readers, then wait for readers which entered before.
+  unsigned int entered=__atomic_fetch_add(&pf_rin, PF_PRES|(ticket&PF_PHID), __ATOMIC_SEQ_CST);
+  while(__atomic_load_n(&pf_rout, __ATOMIC_ACQUIRE)!=entered){
+   lock_pause(&spins);
+  }
+  break;
+ }
+ case LOCK_FUTEX:
+  while(1){
+   int s=__atomic_load_n(&futex_word, __ATOMIC_RELAXED);
+   if(!(s&(WORD_READERS|WORD_WRITER))){
+    if(__atomic_compare_exchange_n(&futex_word, &s, (s&WORD_WAITERS)|WORD_WRITER, 0,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)){
+     break;
+    }
+    continue;
+   }
+   int want=s|WORD_PENDING|WORD_WAITERS;
+   if(s!=want && !__atomic_compare_exchange_n(&futex_word, &s, want, 0,
+                                               __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+    continue;
+   }
+   futex_wait(&futex_word, want);
   }
+  break;
+ case LOCK_BRLOCK:{
+  int j, idle=0;
+  while(!__atomic_compare_exchange_n(&br_writer, &idle, 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)){
+   idle=0;
+   lock_pause(&spins);
+  }
+  for(j=0;j<readers;j++){  //New readers back off, wait for readers already inside.
+   while(__atomic_load_n(&br_slots[j].active, __ATOMIC_SEQ_CST)!=0){
+    lock_pause(&spins);
+   }
+  }
+  break;
+ }
+ }
+}
+
+/*******************************************************************
+ *void writer_unlock()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It releases the selected lock held for writing.
+ *Parameters:
+ *There are no input args to this routine.
+ *This routine does not return anything.
+ *******************************************************************/
+void writer_unlock(){
+ switch(lock_kind){
+ case LOCK_WRITER:
   sem_post(&wsem);     //Signal wsem at exit from critical section.
   sem_wait(&y);        //Signal y at exit from critical section.
   writercount--;       //Reduce writer count at exit.
@@ -93,24 +522,132 @@ void* write()
    sem_post(&rsem);   
   }
   sem_post(&y);        //Unlock semaphore y.
+  break;
+ case LOCK_READER:
+  sem_post(&wsem);
+  break;
+ case LOCK_TICKET:
+  __atomic_fetch_add(&ticket_serving, 1, __ATOMIC_RELEASE);
+  break;
+ case LOCK_PHASE:
+  __atomic_fetch_and(&pf_rin, ~PF_WBITS, __ATOMIC_RELEASE);  //Let blocked readers in.
+  __atomic_fetch_add(&pf_wout, 1, __ATOMIC_RELEASE);         //Let next writer in.
+  break;
+ case LOCK_FUTEX:
+  if(__atomic_exchange_n(&futex_word, 0, __ATOMIC_RELEASE)&WORD_WAITERS){
+   futex_wake(&futex_word);
+  }
+  break;
+ case LOCK_BRLOCK:
+  __atomic_store_n(&br_writer, 0, __ATOMIC_RELEASE);
+  break;
+ }
+}
+
+/*******************************************************************
+ *long long now_ns()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It reads the monotonic clock.
+ *Parameters:
+ *There are no input args to this routine.
+ *long long O/P: Time in nanoseconds.
+ *******************************************************************/
+long long now_ns(){
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return ts.tv_sec*1000000000LL+ts.tv_nsec;
+}
+
+/*******************************************************************
+ *void record_wait(struct lock_stats *stats, long long ns)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It counts one acquisition and adds its wait time to the histogram.
+ *Parameters:
+ *struct lock_stats *stats I/P: Stats of the acquiring thread.
+ *long long ns I/P: Time spent waiting for the lock.
+ *This routine does not return anything.
+ *******************************************************************/
+void record_wait(struct lock_stats *stats, long long ns){
+ int bucket=ns>0 ? 64-__builtin_clzll((unsigned long long)ns) : 0;
+ if(bucket>=WAIT_BUCKETS){
+  bucket=WAIT_BUCKETS-1;
  }
+ stats->acquisitions++;
+ stats->wait_ns+=ns;
+ if(ns>stats->max_wait_ns){
+  stats->max_wait_ns=ns;
+ }
+ stats->hist[bucket]++;
 }
 
+/*******************************************************************
+ *void print_lock_stats(double seconds)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints throughput of the run, acquisitions and wait time of every thread and
+ *             wait time histograms of readers and of the writer.
+ *Parameters:
+ *double seconds I/P: Wall time of the run.
+ *This routine does not return anything.
+ *******************************************************************/
+void print_lock_stats(double seconds){
+ int j, b, lo=WAIT_BUCKETS, hi=-1;
+ long long readers_hist[WAIT_BUCKETS]={0};
+ printf("\n\nLock: %s",lock_names[lock_kind]);
+ printf("\nThroughput: %.0f ops/s in %.3f s",seconds>0 ? 2.0*MAX/seconds : 0.0, seconds);
+ printf("\n%-10s %14s %14s %14s","Thread","Acquisitions","Mean wait(us)","Max wait(us)");
+ for(j=0;j<=readers;j++){
+  struct lock_stats *stats=j<readers ? &reader_states[j].stats : &writer_stats;
+  char name[24];
+  if(j<readers){
+   snprintf(name,sizeof(name),"Reader-%d",j+1);
+  }else{
+   snprintf(name,sizeof(name),"Writer");
+  }
+  printf("\n%-10s %14lld %14.3f %14.3f",name,stats->acquisitions,
+         stats->acquisitions ? stats->wait_ns/1000.0/stats->acquisitions : 0.0,
+         stats->max_wait_ns/1000.0);
+  for(b=0;b<WAIT_BUCKETS;b++){
+   if(j<readers){
+    readers_hist[b]+=stats->hist[b];
+   }
+   if(stats->hist[b]!=0){
+    lo=b<lo ? b : lo;
+    hi=b>hi ? b : hi;
+   }
+  }
+ }
+ printf("\nWait time histogram");
+ printf("\n%-14s %14s %14s","Below(ns)","Readers","Writer");
+ for(b=lo;b<=hi;b++){
+  printf("\n%-14lld %14lld %14lld",1LL<<b,readers_hist[b],writer_stats.hist[b]);
+ }
+}
 
 /*******************************************************************
- *void readarray(void *id)
+ *int readarray(void *id)
  *Author: Prashant Yadav
  *Date: 9/29/2019
- *Description: Read routine calls this routine to read from shared array.This routine also update
- *             readerdata array for each thread.
+ *Description: Read routine calls this routine to read from shared array. Readers share the read
+ *             lock, so next position is claimed with compare and swap and only values already
+ *             written are read.
  *Parameters:
  *id I/P int This is used as a thread id to identify each reader thread.
- *This routine does not return anything.
+ *int O/P: It returns 1 if a value was read and 0 if there was nothing to read.
  ********************************************************************/
-void readarray(void *id){
- //Increase counter to corresponding thread by 1 in readerdata array.
- readerdata[(int)id-1] = readerdata[(int)id-1]+1; 
- printf("\n Reader-%d at Value %d",(int)id, sharedarr[start++]); //Display data and thread id.
+int readarray(void *id){
+ int pos = __atomic_load_n(&start, __ATOMIC_RELAXED);
+ do{
+  if(pos>=end){        //Nothing left to read until writer writes again.
+   return 0;
+  }
+ }while(!__atomic_compare_exchange_n(&start, &pos, pos+1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+ if(!bench_mode){
+  printf("\n Reader-%d at Value %d",(int)(long)id, sharedarr[pos]); //Display data and thread id.
+ }
+ return 1;
 }
 
 /*******************************************************************
@@ -124,23 +661,580 @@ void readarray(void *id){
  *******************************************************************/
 void writerarray(){
  sharedarr[end]=counter++;  //Write to shared array
- printf("\n Writing value %d", sharedarr[end]); //Display data written by writer thread.
- end++;  //Increase end by 1 so that writer writes to next index in next iteration.
+ if(!bench_mode){
+  printf("\n Writing value %d", sharedarr[end]); //Display data written by writer thread.
+ }
+ __atomic_store_n(&end, end+1, __ATOMIC_RELEASE);  //Writer writes to next index in next iteration, waiting readers see it.
+}
+
+/*******************************************************************
+ *int open_miss_counter(unsigned int type, unsigned long long config)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It opens a disabled perf_event counter for this process. Threads created later are
+ *             counted too and their counts are added when they exit.
+ *Parameters:
+ *unsigned int type I/P: Event type, PERF_TYPE_HARDWARE or PERF_TYPE_HW_CACHE.
+ *unsigned long long config I/P: Event.
+ *int O/P: It returns file descriptor of counter or -1 if counter is not available.
+ *******************************************************************/
+int open_miss_counter(unsigned int type, unsigned long long config){
+ struct perf_event_attr attr;
+ memset(&attr, 0, sizeof(attr));
+ attr.size = sizeof(attr);
+ attr.type = type;
+ attr.config = config;
+ attr.disabled = 1;
+ attr.inherit = 1;
+ attr.exclude_kernel = 1;
+ attr.exclude_hv = 1;
+ return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/*******************************************************************
+ *void* fs_worker(void *id)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It increments counter of the thread fs_iterations times. With packed layout counters
+ *             of neighbor threads share cache lines, with padded layout each counter has its own
+ *             line and with local layout thread counts in a register and stores once at exit.
+ *Parameters:
+ *id I/P int This is used as a thread index, starting at 0.
+ *This routine does not return anything.
+ *******************************************************************/
+void* fs_worker(void *id){
+ int t=(int)(long)id;
+ long long n;
+ if(fs_layout==0 || fs_layout==1){
+  volatile long long *slot=fs_layout==0 ? &fs_packed[t] : &fs_padded[t].value;
+  for(n=0;n<fs_iterations;n++){
+   (*slot)++;
+  }
+ }else{
+  long long local=0;
+  for(n=0;n<fs_iterations;n++){
+   local++;
+   __asm__ volatile("" : "+r"(local));  //Keep one increment per iteration.
+  }
+  fs_padded[t].value=local;
+ }
+ return NULL;
+}
+
+/*******************************************************************
+ *void false_sharing_benchmark()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It runs fs_worker with 2, 4, .. 64 threads for every counter layout and prints wall
+ *             time and cache misses counted by perf_event. Misses are printed as n/a where
+ *             perf_event is not available.
+ *Parameters:
+ *There are no input args to this routine.
+ *This routine does not return anything.
+ *******************************************************************/
+void false_sharing_benchmark(){
+ const unsigned long long l1d_miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ<<8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS<<16);
+ pthread_t threads[MAX_READERS];
+ long long ops=0;
+ int t, n;
+ printf("False sharing microbenchmark, %lld increments per thread\n",fs_iterations);
+ printf("%-8s %-8s %12s %10s %16s %16s\n","Threads","Layout","Time(ms)","ns/op","Cache misses","L1D misses");
+ for(n=2;n<=MAX_READERS;n*=2){
+  for(fs_layout=0;fs_layout<FS_LAYOUTS;fs_layout++){
+   int fds[2]={open_miss_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES),
+               open_miss_counter(PERF_TYPE_HW_CACHE, l1d_miss)};
+   long long misses[2]={-1,-1};
+   memset(fs_packed, 0, sizeof(fs_packed));
+   memset(fs_padded, 0, sizeof(fs_padded));
+   for(t=0;t<2;t++){
+    if(fds[t]>=0){
+     ioctl(fds[t], PERF_EVENT_IOC_RESET, 0);
+     ioctl(fds[t], PERF_EVENT_IOC_ENABLE, 0);
+    }
+   }
+   long long begin=now_ns();
+   for(t=0;t<n;t++){
+    pthread_create(&threads[t], NULL, fs_worker, (void *)(long)t);
+   }
+   for(t=0;t<n;t++){
+    pthread_join(threads[t], NULL);
+   }
+   long long elapsed=now_ns()-begin;
+   for(t=0;t<2;t++){
+    if(fds[t]>=0){
+     ioctl(fds[t], PERF_EVENT_IOC_DISABLE, 0);
+     if(read(fds[t], &misses[t], sizeof(misses[t]))!=sizeof(misses[t])){
+      misses[t]=-1;
+     }
+     close(fds[t]);
+    }
+   }
+   for(t=0;t<n;t++){   //Merge counters after join, every thread has to be complete.
+    long long count=fs_layout==0 ? fs_packed[t] : fs_padded[t].value;
+    if(count!=fs_iterations){
+     printf("Thread %d counted %lld of %lld\n",t,count,fs_iterations);
+     exit(1);
+    }
+   }
+   printf("%-8d %-8s %12.3f %10.3f",n,fs_layout_names[fs_layout],elapsed/1e6,(double)elapsed/(n*fs_iterations));
+   for(t=0;t<2;t++){
+    if(misses[t]>=0){
+     printf(" %16lld",misses[t]);
+    }else{
+     printf(" %16s","n/a");
+    }
+   }
+   printf("\n");
+   ops+=n*fs_iterations;
+  }
+ }
+ if(bench_mode){
+  printf("ops=%lld\n",ops);
+ }
+}
+
+/*******************************************************************
+ *void* mix_worker(void *id)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It takes the selected lock mix_ops times, for writing with probability
+ *             mix_write_ratio and for reading otherwise. Writer increments every word of
+ *             mix_data, reader checks that it sees all words equal, i.e. no writer is inside.
+ *Parameters:
+ *id I/P int This is used as a thread index, starting at 0.
+ *This routine does not return anything.
+ *******************************************************************/
+void* mix_worker(void *id){
+ int t=(int)(long)id, w;
+ struct mix_state state;
+ struct prng rng;
+ long long n;
+ memset(&state, 0, sizeof(state));
+ prng_stream(&rng, seed, t);
+ reader_slot=t;
+ for(n=0;n<mix_ops;n++){
+  long long begin=now_ns();
+  if((prng_next(&rng)>>11)*0x1.0p-53<mix_write_ratio){
+   writer_lock();
+   record_wait(&state.write_stats, now_ns()-begin);
+   for(w=0;w<MIX_WORDS;w++){
+    mix_data[w]++;
+   }
+   writer_unlock();
+   state.writes++;
+  }else{
+   reader_lock();
+   record_wait(&state.read_stats, now_ns()-begin);
+   int first=__atomic_load_n(&mix_data[0], __ATOMIC_RELAXED);
+   for(w=1;w<MIX_WORDS;w++){
+    if(__atomic_load_n(&mix_data[w], __ATOMIC_RELAXED)!=first){
+     printf("Reader %d saw a write in progress with %s lock\n",t,lock_names[lock_kind]);
+     exit(1);
+    }
+   }
+   reader_unlock();
+   state.reads++;
+  }
+ }
+ mix_states[t]=state;  //Publish once, main reads it after join.
+ return NULL;
+}
+
+/*******************************************************************
+ *void mix_benchmark()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It runs mix_worker with 1, 2, 4, .. up to readers threads for every lock and
+ *             prints throughput and mean and max wait of read and write acquisitions.
+ *Parameters:
+ *There are no input args to this routine.
+ *This routine does not return anything.
+ *******************************************************************/
+void mix_benchmark(){
+ pthread_t threads[MAX_READERS];
+ long long ops=0;
+ int t, n;
+ printf("Seed %llu\n",(unsigned long long)seed);
+ printf("Read write mix benchmark, %lld acquisitions per thread, %.4f writes\n",mix_ops,mix_write_ratio);
+ printf("%-8s %-8s %14s %14s %14s %14s %14s\n","Threads","Lock","ops/s","Read wait(us)",
+        "Max read(us)","Write wait(us)","Max write(us)");
+ for(n=1;;n=2*n<readers ? 2*n : readers){
+  for(lock_kind=0;lock_kind<LOCKS;lock_kind++){
+   struct lock_stats rs, ws;
+   memset(&rs, 0, sizeof(rs));
+   memset(&ws, 0, sizeof(ws));
+   long long begin=now_ns();
+   for(t=0;t<n;t++){
+    pthread_create(&threads[t], NULL, mix_worker, (void *)(long)t);
+   }
+   for(t=0;t<n;t++){
+    pthread_join(threads[t], NULL);
+   }
+   double seconds=(now_ns()-begin)/1e9;
+   for(t=0;t<n;t++){
+    rs.acquisitions+=mix_states[t].read_stats.acquisitions;
+    rs.wait_ns+=mix_states[t].read_stats.wait_ns;
+    rs.max_wait_ns=mix_states[t].read_stats.max_wait_ns>rs.max_wait_ns ? mix_states[t].read_stats.max_wait_ns : rs.max_wait_ns;
+    ws.acquisitions+=mix_states[t].write_stats.acquisitions;
+    ws.wait_ns+=mix_states[t].write_stats.wait_ns;
+    ws.max_wait_ns=mix_states[t].write_stats.max_wait_ns>ws.max_wait_ns ? mix_states[t].write_stats.max_wait_ns : ws.max_wait_ns;
+   }
+   printf("%-8d %-8s %14.0f %14.3f %14.3f %14.3f %14.3f\n",n,lock_names[lock_kind],
+          seconds>0 ? n*mix_ops/seconds : 0.0,rs.acquisitions ? rs.wait_ns/1000.0/rs.acquisitions : 0.0,
+          rs.max_wait_ns/1000.0,ws.acquisitions ? ws.wait_ns/1000.0/ws.acquisitions : 0.0,ws.max_wait_ns/1000.0);
+   ops+=n*mix_ops;
+  }
+  if(n==readers){
+   break;
+  }
+ }
+ if(bench_mode){
+  printf("ops=%lld\n",ops);
+ }
+}
+
+/*******************************************************************
+ *void deque_push(struct deque *d, unsigned long long task)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: Owner of the deque pushes a chunk at bottom. Caller makes sure deque has room.
+ *Parameters:
+ *struct deque *d I/P: Deque of the calling reader.
+ *unsigned long long task I/P: Chunk to push.
+ *This routine does not return anything.
+ *******************************************************************/
+void deque_push(struct deque *d, unsigned long long task){
+ long long b=__atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+ __atomic_store_n(&d->tasks[b&(DEQUE_SIZE-1)], task, __ATOMIC_RELAXED);
+ __atomic_thread_fence(__ATOMIC_RELEASE);  //Chunk is visible before thieves see new bottom.
+ __atomic_store_n(&d->bottom, b+1, __ATOMIC_RELAXED);
+}
+
+/*******************************************************************
+ *int deque_take(struct deque *d, unsigned long long *task)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: Owner of the deque takes the chunk at bottom. Only for the last chunk it races
+ *             with thieves, which it settles with compare and swap on top.
+ *Parameters:
+ *struct deque *d I/P: Deque of the calling reader.
+ *unsigned long long *task O/P: Chunk taken.
+ *int O/P: It returns 1 if a chunk was taken and 0 if deque is empty.
+ *******************************************************************/
+int deque_take(struct deque *d, unsigned long long *task){
+ long long b=__atomic_load_n(&d->bottom, __ATOMIC_RELAXED)-1;
+ __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+ __atomic_thread_fence(__ATOMIC_SEQ_CST);  //Bottom is lowered before top is read.
+ long long t=__atomic_load_n(&d->top, __ATOMIC_RELAXED);
+ if(t>b){
+  __atomic_store_n(&d->bottom, b+1, __ATOMIC_RELAXED);
+  return 0;
+ }
+ *task=__atomic_load_n(&d->tasks[b&(DEQUE_SIZE-1)], __ATOMIC_RELAXED);
+ if(t==b){   //Last chunk, a thief may take it first.
+  int won=__atomic_compare_exchange_n(&d->top, &t, t+1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+  __atomic_store_n(&d->bottom, b+1, __ATOMIC_RELAXED);
+  return won;
+ }
+ return 1;
+}
+
+/*******************************************************************
+ *int deque_steal(struct deque *d, unsigned long long *task)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: Another reader steals the chunk at top of the deque.
+ *Parameters:
+ *struct deque *d I/P: Deque of the victim.
+ *unsigned long long *task O/P: Chunk stolen.
+ *int O/P: It returns 1 if a chunk was stolen, 0 if deque is empty and -1 if another thread
+ *         took the chunk first.
+ *******************************************************************/
+int deque_steal(struct deque *d, unsigned long long *task){
+ long long t=__atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+ __atomic_thread_fence(__ATOMIC_SEQ_CST);  //Top is read before bottom.
+ long long b=__atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+ if(t>=b){
+  return 0;
+ }
+ *task=__atomic_load_n(&d->tasks[t&(DEQUE_SIZE-1)], __ATOMIC_RELAXED);
+ if(!__atomic_compare_exchange_n(&d->top, &t, t+1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)){
+  return -1;
+ }
+ return 1;
+}
+
+/*******************************************************************
+ *void* partition_writer(void *id)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: Each writer of the partitioned buffer starts execution from this routine. It
+ *             writes its partition in order and publishes every value with a release store of
+ *             the written count, so its owner reads only written values.
+ *Parameters:
+ *id I/P int This is used as a writer index, starting at 0.
+ *This routine does not return anything.
+ *******************************************************************/
+void* partition_writer(void *id){
+ struct partition *p=&partitions[(int)(long)id];
+ int k;
+ for(k=0;k<p->size;k++){
+  sharedarr[p->base+k]=p->base+k;  //Values are their positions, as with one writer.
+  if(!bench_mode){
+   printf("\n Writer-%d writing value %d",(int)(long)id+1,sharedarr[p->base+k]);
+  }
+  __atomic_store_n(&p->written, k+1, __ATOMIC_RELEASE);
+ }
+ return NULL;
 }
 
 /*******************************************************************
- *void main()
+ *int refill_deque(int r)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It moves values written to the partitions of a reader into its deque in chunks of
+ *             CHUNK values, at most DEQUE_SIZE chunks. It is called when the deque is empty.
+ *Parameters:
+ *int r I/P: Reader index, starting at 0.
+ *int O/P: It returns number of chunks pushed.
+ *******************************************************************/
+int refill_deque(int r){
+ int w, pushed=0;
+ for(w=r;w<writers && pushed<DEQUE_SIZE;w+=readers){
+  struct partition *p=&partitions[w];
+  int written=__atomic_load_n(&p->written, __ATOMIC_ACQUIRE);
+  while(p->taken<written && pushed<DEQUE_SIZE){
+   int len=written-p->taken<CHUNK ? written-p->taken : CHUNK;
+   deque_push(&deques[r], ((unsigned long long)(p->base+p->taken)<<32)|len);
+   p->taken+=len;
+   pushed++;
+  }
+ }
+ return pushed;
+}
+
+/*******************************************************************
+ *void* stealing_reader(void *id)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: Each reader of the partitioned buffer starts execution from this routine. It reads
+ *             chunks from its own deque, refills it from its partitions when it is empty and
+ *             steals from a random other reader when there is nothing to refill, until every
+ *             value is read. Every value is checked against its position.
+ *Parameters:
+ *id I/P int This is used as a reader index, starting at 0.
+ *This routine does not return anything.
+ *******************************************************************/
+void* stealing_reader(void *id){
+ int r=(int)(long)id, spins=0, k;
+ struct steal_state state;
+ struct prng rng;
+ long long reads=0;
+ memset(&state, 0, sizeof(state));
+ prng_stream(&rng, seed+1, r);   //Victims, apart from streams of mix benchmark
+ while(__atomic_load_n(&remaining, __ATOMIC_ACQUIRE)>0){
+  unsigned long long task;
+  if(!deque_take(&deques[r], &task)){
+   if(refill_deque(r)>0){
+    state.refills++;
+    continue;
+   }
+   if(readers==1){
+    lock_pause(&spins);
+    continue;
+   }
+   int victim=(int)prng_bounded(&rng, readers-1);
+   victim+=victim>=r;   //Any reader but this one.
+   state.attempts++;
+   if(deque_steal(&deques[victim], &task)!=1){
+    lock_pause(&spins);
+    continue;
+   }
+   state.steals++;
+  }
+  spins=0;
+  int pos=(int)(task>>32), len=(int)(task&0xffffffff);
+  for(k=pos;k<pos+len;k++){
+   if(sharedarr[k]!=k){  //Chunk holds only values published by their writer.
+    printf("\nReader-%d read %d at position %d before it was written\n",r+1,sharedarr[k],k);
+    exit(1);
+   }
+   if(!bench_mode){
+    printf("\n Reader-%d at Value %d",r+1,sharedarr[k]);
+   }
+  }
+  reads+=len;
+  __atomic_fetch_sub(&remaining, len, __ATOMIC_RELEASE);
+ }
+ reader_states[r].reads=reads;  //Publish local counters once, main reads them after join.
+ steal_states[r]=state;
+ return NULL;
+}
+
+/*******************************************************************
+ *void partitioned_run()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It splits shared array into one partition per writer, runs writers and work
+ *             stealing readers and prints reads, steals and refills of every reader, throughput
+ *             and load balance. Load balance is most reads of a reader over mean reads and
+ *             Jain's fairness index of reads.
+ *Parameters:
+ *There are no input args to this routine.
+ *This routine does not return anything.
+ *******************************************************************/
+void partitioned_run(){
+ pthread_t writer_threads[MAX_WRITERS], reader_threads[MAX_READERS];
+ long long steals=0, attempts=0, most=0;
+ double sum=0, sum_sq=0;
+ int w, j;
+ for(w=0;w<writers;w++){
+  partitions[w].base=(int)((long long)MAX*w/writers);
+  partitions[w].size=(int)((long long)MAX*(w+1)/writers)-partitions[w].base;
+ }
+ remaining=MAX;
+ printf("\n Execution Started....");
+ long long begin=now_ns();
+ for(w=0;w<writers;w++){
+  pthread_create(&writer_threads[w], NULL, partition_writer, (void *)(long)w);
+ }
+ for(j=0;j<readers;j++){
+  pthread_create(&reader_threads[j], NULL, stealing_reader, (void *)(long)j);
+ }
+ for(w=0;w<writers;w++){
+  pthread_join(writer_threads[w], NULL);
+ }
+ for(j=0;j<readers;j++){
+  pthread_join(reader_threads[j], NULL);
+ }
+ double seconds=(now_ns()-begin)/1e9;
+ for(j=0;j<readers;j++){
+  printf("\nReader-%d reads %lld times, %lld steals of %lld attempts, %lld refills",j+1,reader_states[j].reads,
+         steal_states[j].steals,steal_states[j].attempts,steal_states[j].refills);
+  steals+=steal_states[j].steals;
+  attempts+=steal_states[j].attempts;
+  most=reader_states[j].reads>most ? reader_states[j].reads : most;
+  sum+=reader_states[j].reads;
+  sum_sq+=(double)reader_states[j].reads*reader_states[j].reads;
+ }
+ printf("\n\nPartitioned buffer: %d writers, %d readers, seed %llu",writers,readers,(unsigned long long)seed);
+ printf("\nThroughput: %.0f ops/s in %.3f s",seconds>0 ? 2.0*MAX/seconds : 0.0, seconds);
+ printf("\nLoad balance: max/mean reads %.3f, Jain index %.4f, %lld steals of %lld attempts",
+        sum>0 ? most*readers/sum : 0.0,sum_sq>0 ? sum*sum/(readers*sum_sq) : 1.0,steals,attempts);
+ printf("\n Execution ends here...");
+ if(bench_mode){
+  printf("\nops=%lld\n",2LL*MAX);   //Every value is written once and read once
+ }
+}
+
+/*******************************************************************
+ *void parse_arguments(int argc, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It parses command line options.
+ *             --max N        Size of shared array (default 1000000).
+ *             --bench        Suppress per value output and print operation count.
+ *             --seed N       Seed of random number streams of --mix and --writers (default current
+ *                            time).
+ *             --lock NAME    Reader writer lock, reader, writer, ticket, phase, futex or brlock
+ *                            (default writer).
+ *             --readers N    Number of reader threads, 1 to 64 (default 10).
+ *             --false-sharing  Run false sharing microbenchmark instead.
+ *             --iterations N Increments per thread of the microbenchmark (default 1000000).
+ *             --mix W        Run read write mix benchmark with share W of writes (0 to 1) on
+ *                            1, 2, 4, .. up to --readers threads instead.
+ *             --mix-ops N    Lock acquisitions per thread of the mix benchmark (default 20000).
+ *             --writers N    Split shared array into N partitions, 1 to 64, each filled by its own
+ *                            writer and read by work stealing readers without a lock.
+ *Parameters:
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments.
+ *This routine does not return anything.
+ *******************************************************************/
+void parse_arguments(int argc, char *argv[]){
+ int i;
+ seed = (uint64_t)time(0);
+ for(i=1;i<argc;i++){
+  if(strcmp(argv[i],"--max")==0 && i+1<argc){
+   MAX = atoi(argv[++i]);
+  }else if(strcmp(argv[i],"--bench")==0){
+   bench_mode = 1;
+  }else if(strcmp(argv[i],"--seed")==0 && i+1<argc){
+   seed = strtoull(argv[++i], NULL, 0);
+  }else if(strcmp(argv[i],"--lock")==0 && i+1<argc){
+   i++;
+   for(lock_kind=0;lock_kind<LOCKS && strcmp(argv[i],lock_names[lock_kind])!=0;lock_kind++);
+   if(lock_kind==LOCKS){
+    printf("Unknown lock %s, use reader, writer, ticket, phase, futex or brlock\n",argv[i]);
+    exit(1);
+   }
+  }else if(strcmp(argv[i],"--readers")==0 && i+1<argc){
+   readers = atoi(argv[++i]);
+  }else if(strcmp(argv[i],"--false-sharing")==0){
+   fs_mode = 1;
+  }else if(strcmp(argv[i],"--iterations")==0 && i+1<argc){
+   fs_iterations = atoll(argv[++i]);
+  }else if(strcmp(argv[i],"--mix")==0 && i+1<argc){
+   mix_write_ratio = atof(argv[++i]);
+   if(mix_write_ratio<0 || mix_write_ratio>1){
+    printf("Write share must be between 0 and 1\n");
+    exit(1);
+   }
+  }else if(strcmp(argv[i],"--mix-ops")==0 && i+1<argc){
+   mix_ops = atoll(argv[++i]);
+  }else if(strcmp(argv[i],"--writers")==0 && i+1<argc){
+   writers = atoi(argv[++i]);
+   if(writers<1 || writers>MAX_WRITERS){
+    printf("Number of writers must be between 1 and %d\n",MAX_WRITERS);
+    exit(1);
+   }
+  }else{
+   printf("Usage: %s [--max N] [--bench] [--seed N]\n"
+          "          [--lock reader|writer|ticket|phase|futex|brlock] [--readers N]\n"
+          "          [--false-sharing] [--iterations N] [--mix W] [--mix-ops N] [--writers N]\n",argv[0]);
+   exit(1);
+  }
+ }
+ if(MAX<1){
+  printf("Shared array size must be positive\n");
+  exit(1);
+ }
+ if(readers<1 || readers>MAX_READERS){
+  printf("Number of readers must be between 1 and %d\n",MAX_READERS);
+  exit(1);
+ }
+ if(fs_iterations<1 || mix_ops<1){
+  printf("Iterations must be positive\n");
+  exit(1);
+ }
+ if(writers!=0 && (fs_mode || mix_write_ratio>=0)){
+  printf("--writers can not be combined with --false-sharing and --mix\n");
+  exit(1);
+ }
+}
+
+/*******************************************************************
+ *int main(int argc, char *argv[])
  *Author: Prashant Yadav
  *Date: 9/29/2019
- *Description: Program execution starts from this routine, 10 reader threads and 1 writer thread
+ *Description: Program execution starts from this routine, reader threads and 1 writer thread
  *             are spawed here and later joined. It also displays stats of read count for every
- *             reader thread.
+ *             reader thread and stats of the selected lock. With --writers the partitioned buffer
+ *             is run instead.
  *Parameters:
- *It does not take any input args.
- *This routine does not return anything.
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments, see parse_arguments.
+ *int O/P: It returns 0 on success.
  *******************************************************************/
-void main()
+int main(int argc, char *argv[])
 {
+ parse_arguments(argc, argv);
+ if(fs_mode){
+  false_sharing_benchmark();
+  return 0;
+ }
+ sharedarr = (int*)malloc(MAX*sizeof(int));
  readercount=0;    //Initialize readercount to zero
  writercount=0;    //Initialize writercount to zero
  sem_init(&x,0,1); //Initialize all semaphores with intial value 1. 
@@ -148,28 +1242,42 @@ void main()
  sem_init(&z,0,1); //of a process.
  sem_init(&rsem,0,1);
  sem_init(&wsem,0,1);
- pthread_t readers[10], writer;  //10 readers and 1 writer pthread.
- int j;
- for(j=0;j<10;j++)
- { readerdata[j]=0;    //Initialize readerdata array to store read count for each thread.
+ if(mix_write_ratio>=0){  //Mix benchmark takes the same locks from its own threads.
+  mix_benchmark();
+  free(sharedarr);
+  return 0;
  }
+ if(writers!=0){          //Partitioned buffer takes no lock.
+  partitioned_run();
+  free(sharedarr);
+  return 0;
+ }
+ pthread_t reader_threads[MAX_READERS], writer;  //Reader pthreads and 1 writer pthread.
+ int j;
  printf("\n Execution Started....");
- pthread_create(&writer, NULL, write, NULL);  //Initalize writer pthread.
- int i;
- for(i=0;i<10;i++){
-  pthread_create(&readers[i], NULL, read, (void *)i+1); //Initialize 10 reader pthreads.
+ long long begin=now_ns();
+ pthread_create(&writer, NULL, write_routine, NULL);  //Initalize writer pthread.
+ long i;
+ for(i=0;i<readers;i++){
+  pthread_create(&reader_threads[i], NULL, read_routine, (void *)(i+1)); //Initialize reader pthreads.
  }
  pthread_join(writer,NULL);  //Join writer pthread.
- for(i=0;i<10;i++){
-  pthread_join(readers[i], NULL);  //join each reader pthread.
+ for(i=0;i<readers;i++){
+  pthread_join(reader_threads[i], NULL);  //join each reader pthread.
  }
- for(j=0;j<10;j++){
-  printf("\nReader-%d reads %d times",j+1, readerdata[j]);   //Print read count of each reader pthread.
+ for(j=0;j<readers;j++){
+  printf("\nReader-%d reads %lld times",j+1, reader_states[j].reads);   //Print read count of each reader pthread.
  } 
+ print_lock_stats((now_ns()-begin)/1e9);
  printf("\n Execution ends here...");
+ if(bench_mode){
+  printf("\nops=%lld\n",2LL*MAX);   //Every value is written once and read once
+ }
  sem_destroy(&x);  //Destroy all used semaphores.
  sem_destroy(&y);
  sem_destroy(&z);
  sem_destroy(&rsem);
  sem_destroy(&wsem);
+ free(sharedarr);
+ return 0;
 }
@@ -10,9 +10,39 @@
  *reset_time_counter - Reset time counter after each iteration.
  *print_mem_loc - Routine to print the memory locations in order to verify memory locations. 
  *complete_queued_process - Routine to update time counter before starting next iteration.
+ *bitmap_init - Allocates free-space bitmap and its summary words for bitmap hole search.
+ *bitmap_mark - Marks a range of memory locations as free or used in the free-space bitmap.
+ *find_hole_scan - Finds first hole of required size by scanning memory locations one by one.
+ *find_hole_bitmap - Finds first hole of required size with word level operations on the bitmap.
+ *benchmark_hole_search - Times both hole search routines on current memory state.
+ *memory_free_stats - Finds total free memory and largest hole.
+ *drain_time_estimate - Estimates ticks until a hole of required size appears without compaction.
+ *compact_memory - Slides all live memory locations towards the start of memory.
  *allocate_memory - Routine accept a process to allocate memory for given allocation type.
  *simulate_memory_allocation - Routine to simulate memory allocation for 1000 proceses for given
  *                             allocation type. 
+ *print_compaction_stats - Prints compaction cost against drain time saved.
+ *print_search_latency - Prints average hole search latency for scan and bitmap search.
+ *block_start - Returns first block boundary at or after a memory location.
+ *bitmap_next_run - Finds next run of free memory locations in free-space bitmap.
+ *bitmap_used_top - Finds last used memory location in free-space bitmap.
+ *trace_find_hole - Finds place for an allocation of a trace by first, next or best fit.
+ *live_find - Finds an allocation in table of live allocations.
+ *live_insert - Records a live allocation.
+ *live_remove - Removes a freed allocation.
+ *trace_fragmentation - Returns fragmentation of heap below its top.
+ *trace_sample - Adds a point to footprint and fragmentation time series.
+ *replay_trace - Replays malloc and free trace for one allocation type and fit.
+ *heap_acquire - Takes heap lock, counting contended acquisitions.
+ *size_class - Returns size class of an allocation for thread caches.
+ *central_refill - Moves a batch of blocks from central pool into a thread cache.
+ *central_return - Moves a batch of blocks from a thread cache back to central pool.
+ *thread_alloc - Allocates memory for a thread with global lock or thread cache.
+ *thread_free - Frees memory of a thread with global lock or thread cache.
+ *allocator_worker - Thread routine allocating and freeing memory.
+ *run_concurrent - Runs allocator threads once and prints rate, contention and fragmentation.
+ *simulate_concurrent - Runs concurrent allocator for growing thread counts.
+ *parse_arguments - Parses command line options.
  *main - Driver main routine from where program starts executing. Here we start simulation for 
  *        three different configuration i.e. memory allocation type.
  *******************************************************************/
@@ -20,19 +50,97 @@
 #include<stdlib.h>
 #include<time.h>
 #include<string.h>
-#define TOTAL_PROCESS 1000    //Macro to declare total process
-#define SIMULATIONS 1000      //Macro to declare total simulations
+#include<pthread.h>
+#include "../common/prng.h"
+#include "../common/stats.h"
+#define TOTAL_PROCESS 1000    //Macro to declare default total process
+#define SIMULATIONS 1000      //Macro to declare default total simulations
 #define STATIC_MEM_ALLOC "Static memory allocation with equal block size"  //Static equal sized memory locations macro
 #define STATIC_UNEQL_MEM_ALLOC "Static memory allocation with unequal block size" //Static unequal sized memory locations macro
 #define DYNM_MEM_ALLOC "Dynamic memory allocation" //Macro to denote dynamic memory allocation
+#define SEARCH_REPEAT 16      //Repetitions of each hole search while measuring latency
 int static_fixed_mem_alloc[] = {8,8,8,8,8,8,8};  //Block sized memory blocks
 int static_variable_mem_alloc[] = {2,4,6,8,8,12,16};  //Unequal sized memory blocks
-int memory_location[56];  //56 memory locations
+int total_process=TOTAL_PROCESS;  //Processes generated in each simulation
+int simulations=SIMULATIONS;      //Simulations for each allocation type
+double ci_width=0;        //Stop once 95% confidence interval of time is within ci_width of mean, 0 never
+int min_runs=10;          //Fewest simulations of an allocation type before it may stop
+int runs=0;               //Simulations run for last allocation type
+long long total_runs=0;   //Simulations run for all allocation types
+int bench_mode=0;         //1 to print operation count at end
+int memory_size=56;       //Number of memory locations, 56 by default
+int *memory_location;     //Remaining time of process holding each memory location
 int time_taken=0;  //Track time taken for 1000 processes completion
+struct prng rng;      //Random number stream for process generation
+uint64_t seed;        //Seed of the random number stream
+//Free-space bitmap, one bit per memory location, bit is 1 when location is free.
+//Each summary bit tells whether corresponding bitmap word has at least one free location.
+unsigned long long *free_bitmap, *free_summary;
+int bitmap_words, summary_words;
+int use_bitmap=0;          //1 when hole search uses free-space bitmap
+int search_benchmark=0;    //1 when latency of both hole searches is measured
+long long scan_search_ns=0, bitmap_search_ns=0, search_count=0;
+volatile int search_sink;  //Keeps benchmarked searches from being optimized away
+int compact_on_demand=0;   //1 when dynamic allocation compacts memory if no hole is big enough
+double compact_threshold=0; //Compact proactively when fragmentation exceeds this value, 0 disables
+double move_cost=0.1;      //Modeled time to move one memory location during compaction
+double compaction_time=0;  //Time charged for compaction in current simulation run
+long long compactions=0, proactive_compactions=0, moved_locations=0, drain_time_saved=0;
+long long allocated_processes=0;  //Processes which got memory, counted for compaction report
 struct Process{       //Process structure with memory and time requirement as paramter
   int time_required;
   int memory_required;
 };
+//Allocation trace replay. Memory locations are a heap of trace_unit bytes each and a used
+//location holds 1. Live allocations of trace are kept in a hash table by id.
+#define FIT_FIRST 0
+#define FIT_NEXT 1
+#define FIT_BEST 2
+#define SERIES_POINTS 32      //Most points of fragmentation time series
+const char *trace_path=NULL;
+int trace_unit=16;            //Bytes in a memory location
+int memory_given=0;           //1 when --memory is given, trace heap is 1M locations otherwise
+struct live_block{
+  unsigned long long id;
+  int start, end;             //Locations of allocation, start is -1 for an empty slot
+};
+struct live_block *live_table;
+int live_capacity=0, live_count=0;   //Capacity is a power of 2
+int live_locations, heap_top, next_fit;   //Used locations, 1 past last used one, next fit start
+struct series_point{
+  long long time;
+  int top, live;
+  double fragmentation;
+};
+struct series_point series[SERIES_POINTS];
+int series_count, series_every;   //Points and events between points
+long long trace_events=0;     //Events replayed by all allocation types
+//Concurrent allocator. Threads allocate and free dynamic memory either all through one heap
+//lock or through caches of size class blocks, refilled from and returned to a central pool
+//in batches under same lock.
+#define MAX_THREADS 64
+#define MAX_LIVE 256              //Most allocations a thread holds
+#define SIZE_CLASSES 7            //Blocks of 1, 2, 4, ... 64 locations
+#define MODE_GLOBAL 0
+#define MODE_CACHE 1
+int concurrent_threads=0;         //Most threads of concurrent allocator, 0 when not run
+long long thread_ops=20000;       //Allocations and frees of each thread
+int cache_batch=16;               //Blocks moved between a thread cache and central pool at once
+pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+int *central_blocks[SIZE_CLASSES];   //Central pool, first location of each free block of a class
+int central_count[SIZE_CLASSES], central_capacity[SIZE_CLASSES];
+struct thread_heap{
+  struct prng rng;
+  int id, mode;
+  int live_start[MAX_LIVE], live_size[MAX_LIVE], live_count;
+  int *cache[SIZE_CLASSES];       //Free blocks of each class, up to 2*cache_batch
+  int cache_count[SIZE_CLASSES];
+  long long allocations, frees, failed, live_locations;
+  long long acquisitions, contended, wait_ns;   //Heap lock acquisitions of thread
+} __attribute__((aligned(64)));   //Threads do not share cache lines
+struct thread_heap *thread_heaps;
+long long concurrent_ops=0;       //Allocations and frees of all runs
+void bitmap_mark(int start, int end, int free);  //Declaration of bitmap_mark routine
 
 /*******************************************************************
  *void clear_memory()
@@ -45,9 +153,12 @@ struct Process{       //Process structure with memory and time requirement as pa
  *******************************************************************/
 void clear_memory(){
   int i=0;
-  for(i=0;i<56;i++){
+  for(i=0;i<memory_size;i++){
     memory_location[i]=0;   //Reseting value for each memory location to 0
   }
+  if(use_bitmap){
+    bitmap_mark(0, memory_size-1, 1);  //Every location is free again
+  }
 }
 
 /*******************************************************************
@@ -61,15 +172,19 @@ void clear_memory(){
  *******************************************************************/
 void update_memory_location(){
   int i=0;
-  for(i=0;i<56;i++){
+  for(i=0;i<memory_size;i++){
     if(memory_location[i]>0){
       memory_location[i]-=1;   //Reduce value at each memroy location by 1 if it is non zero
+      if(use_bitmap && memory_location[i]==0){  //Location became free, set its bit.
+        free_bitmap[i>>6] |= 1ULL<<(i&63);
+        free_summary[i>>12] |= 1ULL<<((i>>6)&63);
+      }
     }
   }
 }
 
 /*******************************************************************
- *void allocate_static_fixed_mem(int start, int end, struct Process process)
+ *int allocate_static_fixed_mem(int start, int end, struct Process process)
  *Author: Prashant Yadav
  *Date: 10/13/2019
  *Description: It allocates memory for each process with equal sized memory blocks in 
@@ -78,18 +193,19 @@ void update_memory_location(){
  *int start I/P: This gives start index for memory allocation
  *int end I/P: End index of memory location.
  *struct Process process I/P:The process for which memory has to be allocated.
- *This routine does not return anything.
+ *int O/P: It returns last memory location allocated to the process.
  *******************************************************************/
-void allocate_static_fixed_mem(int start, int end, struct Process process){
+int allocate_static_fixed_mem(int start, int end, struct Process process){
   int possible_end=7;
   while(possible_end<end){   //Find next possible end for the block.
     possible_end+=8;
   }
-  end=possible_end;
+  end=possible_end<memory_size?possible_end:memory_size-1;
   int i;
   for(i=start;i<=end;i++){
     memory_location[i]=process.time_required;
   }
+  return end;
 }
 
 /*******************************************************************
@@ -107,30 +223,31 @@ void reset_time_counter(){
 
 
 /*******************************************************************
- *void allocate_static_var_mem(int start, int end, struct Process process)
+ *int allocate_static_var_mem(int start, int end, struct Process process)
  *Author: Prashant Yadav
  *Date: 10/13/2019
  *Description: It allocates memory for each process with unequal sized memory blocks in 
- *             memory_location array.
+ *             memory_location array. Block sizes repeat when memory is larger than 56 locations.
  *Parameters:
  *int start I/P: This gives start index for memory allocation
  *int end I/P: End index of memory location.
  *struct Process process I/P:The process for which memory has to be allocated.
- *This routine does not return anything.
+ *int O/P: It returns last memory location allocated to the process.
  *******************************************************************/
-void allocate_static_var_mem(int start, int end, struct Process process){
+int allocate_static_var_mem(int start, int end, struct Process process){
   int possible_end=1, i=1;
   while(possible_end<end){   //Find next possible ending for the block.
-    possible_end+=static_variable_mem_alloc[i++];
+    possible_end+=static_variable_mem_alloc[(i++)%7];
   }
-  end = possible_end;
+  end=possible_end<memory_size?possible_end:memory_size-1;
   for(i=start;i<=end;i++){
     memory_location[i]=process.time_required;
   }
+  return end;
 }
 
 /*******************************************************************
- *void allocate_dynamic_mem(int start, int end, struct Process process)
+ *int allocate_dynamic_mem(int start, int end, struct Process process)
  *Author: Prashant Yadav
  *Date: 10/13/2019
  *Description: It allocates memory for each process dynamically in 
@@ -139,13 +256,14 @@ void allocate_static_var_mem(int start, int end, struct Process process){
  *int start I/P: This gives start index for memory allocation
  *int end I/P: End index of memory location.
  *struct Process process I/P:The process for which memory has to be allocated.
- *This routine does not return anything.
+ *int O/P: It returns last memory location allocated to the process.
  *******************************************************************/
-void allocate_dynamic_mem(int start, int end, struct Process process){
+int allocate_dynamic_mem(int start, int end, struct Process process){
   int i;
   for(i=start; i<=end;i++){
     memory_location[i] = process.time_required;
   }
+  return end;
 }
 
 /*******************************************************************
@@ -160,7 +278,7 @@ void allocate_dynamic_mem(int start, int end, struct Process process){
  *******************************************************************/
 void print_mem_loc(){
   int i;
-  for(i=0;i<56;i++){
+  for(i=0;i<memory_size;i++){
     printf("%d ",memory_location[i]);
   }
   printf("\n");
@@ -177,7 +295,7 @@ void print_mem_loc(){
  *******************************************************************/
 void complete_queued_process(){
   int max_time = memory_location[0],i;
-  for(i=1;i<56;i++){
+  for(i=1;i<memory_size;i++){
     max_time=max_time<memory_location[i]?memory_location[i]:max_time;
   }
   time_taken+=max_time;    //Update the time_taken variable by max time in location array
@@ -185,6 +303,269 @@ void complete_queued_process(){
 }
 
 
+/*******************************************************************
+ *void bitmap_init()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It allocates free-space bitmap with one bit per memory location and summary
+ *             words with one bit per bitmap word. All locations start free.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void bitmap_init(){
+  bitmap_words = (memory_size+63)/64;
+  summary_words = (bitmap_words+63)/64;
+  free_bitmap = (unsigned long long*)calloc(bitmap_words, sizeof(unsigned long long));
+  free_summary = (unsigned long long*)calloc(summary_words, sizeof(unsigned long long));
+  bitmap_mark(0, memory_size-1, 1);
+}
+
+/*******************************************************************
+ *void bitmap_mark(int start, int end, int free)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It marks memory locations from start to end as free or used. Whole words
+ *             are written at once and summary bits of touched words are refreshed.
+ *Parameters:
+ *int start I/P: First memory location of the range.
+ *int end I/P: Last memory location of the range.
+ *int free I/P: 1 to mark range free, 0 to mark it used.
+ *This routine does not return anything.
+ *******************************************************************/
+void bitmap_mark(int start, int end, int free){
+  int w, first=start>>6, last=end>>6;
+  for(w=first;w<=last;w++){
+    unsigned long long mask = ~0ULL;
+    if(w==first){
+      mask &= ~0ULL<<(start&63);
+    }
+    if(w==last && (end&63)!=63){
+      mask &= (1ULL<<((end&63)+1))-1;
+    }
+    if(free){
+      free_bitmap[w] |= mask;
+    }else{
+      free_bitmap[w] &= ~mask;
+    }
+    if(free_bitmap[w]!=0){  //Keep summary bit in sync with the word.
+      free_summary[w>>6] |= 1ULL<<(w&63);
+    }else{
+      free_summary[w>>6] &= ~(1ULL<<(w&63));
+    }
+  }
+}
+
+/*******************************************************************
+ *int find_hole_scan(int required, int *start, int *end)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds first hole of required size by testing one memory location at a time.
+ *Parameters:
+ *int required I/P: Number of memory locations required.
+ *int *start O/P: First location of the hole.
+ *int *end O/P: Last location of the hole.
+ *int O/P: return 1 if hole is found otherwise return 0.
+ *******************************************************************/
+int find_hole_scan(int required, int *start, int *end){
+  int i,hole_start=0,hole_end=-1;
+  for(i=0;i<memory_size;i++){      //Loop to find first instance where required memory is available.
+    if(memory_location[i]==0){
+      hole_end=i;
+    }
+    else{
+      hole_start=i+1;   //Hole can only start after the used location.
+      hole_end=i;
+    }
+    if((hole_end-hole_start+1)>=required){
+      *start=hole_start;
+      *end=hole_end;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*******************************************************************
+ *int find_hole_bitmap(int required, int *start, int *end)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds first hole of required size in free-space bitmap. Summary words are
+ *             used to skip fully used words, a run of free bits crossing word boundaries
+ *             is tracked with count of leading and trailing ones and a run inside a word
+ *             is found by shifting and masking the word with itself.
+ *Parameters:
+ *int required I/P: Number of memory locations required.
+ *int *start O/P: First location of the hole.
+ *int *end O/P: Last location of the hole.
+ *int O/P: return 1 if hole is found otherwise return 0.
+ *******************************************************************/
+int find_hole_bitmap(int required, int *start, int *end){
+  int s,run=0,prev=-1;
+  for(s=0;s<summary_words;s++){
+    unsigned long long summary = free_summary[s];
+    while(summary!=0){
+      int w = (s<<6)+__builtin_ctzll(summary);
+      unsigned long long word = free_bitmap[w];
+      summary &= summary-1;
+      if(w!=prev+1){   //Skipped words are fully used, so the run is broken.
+        run=0;
+      }
+      prev=w;
+      if(word==~0ULL){
+        run+=64;
+        if(run>=required){
+          *start=(w<<6)+64-run;
+          *end=*start+required-1;
+          return 1;
+        }
+        continue;
+      }
+      int low = __builtin_ctzll(~word);   //Free locations continuing the previous run.
+      if(run+low>=required){
+        *start=(w<<6)-run;
+        *end=*start+required-1;
+        return 1;
+      }
+      if(required<=64){
+        unsigned long long fit = word;
+        int len=1;
+        while(len<required){   //Bit i stays set only if bits i..i+len-1 are all free.
+          int shift = len<required-len?len:required-len;
+          fit &= fit>>shift;
+          len+=shift;
+        }
+        if(fit!=0){
+          *start=(w<<6)+__builtin_ctzll(fit);
+          *end=*start+required-1;
+          return 1;
+        }
+      }
+      run = __builtin_clzll(~word);   //Free locations at top of the word start a new run.
+    }
+  }
+  return 0;
+}
+
+/*******************************************************************
+ *void benchmark_hole_search(int required)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It times scan and bitmap hole search on current memory state and adds
+ *             elapsed time to the latency counters.
+ *Parameters:
+ *int required I/P: Number of memory locations required.
+ *This routine does not return anything.
+ *******************************************************************/
+void benchmark_hole_search(int required){
+  struct timespec t0,t1,t2;
+  int i,start,end,found=0;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(i=0;i<SEARCH_REPEAT;i++){
+    found += find_hole_scan(required, &start, &end);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  for(i=0;i<SEARCH_REPEAT;i++){
+    found += find_hole_bitmap(required, &start, &end);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t2);
+  search_sink = found;
+  scan_search_ns += (t1.tv_sec-t0.tv_sec)*1000000000LL + (t1.tv_nsec-t0.tv_nsec);
+  bitmap_search_ns += (t2.tv_sec-t1.tv_sec)*1000000000LL + (t2.tv_nsec-t1.tv_nsec);
+  search_count += SEARCH_REPEAT;
+}
+
+/*******************************************************************
+ *void memory_free_stats(int *total_free, int *largest_hole)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds total number of free memory locations and size of largest hole.
+ *Parameters:
+ *int *total_free O/P: Number of free memory locations.
+ *int *largest_hole O/P: Size of largest run of free memory locations.
+ *This routine does not return anything.
+ *******************************************************************/
+void memory_free_stats(int *total_free, int *largest_hole){
+  int i,run=0;
+  *total_free=0;
+  *largest_hole=0;
+  for(i=0;i<memory_size;i++){
+    if(memory_location[i]==0){
+      (*total_free)++;
+      run++;
+      *largest_hole = run>*largest_hole?run:*largest_hole;
+    }else{
+      run=0;
+    }
+  }
+}
+
+/*******************************************************************
+ *int drain_time_estimate(int required)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It estimates how many ticks a process would wait without compaction, i.e.
+ *             the first tick at which locations freed by running processes form a hole
+ *             of required size.
+ *Parameters:
+ *int required I/P: Number of memory locations required.
+ *int O/P: It returns number of ticks until hole is available.
+ *******************************************************************/
+int drain_time_estimate(int required){
+  int i,tick,max_time=0;
+  for(i=0;i<memory_size;i++){
+    max_time = memory_location[i]>max_time?memory_location[i]:max_time;
+  }
+  for(tick=1;tick<max_time;tick++){
+    int run=0;
+    for(i=0;i<memory_size;i++){
+      run = memory_location[i]<=tick?run+1:0;   //Location is free after given ticks
+      if(run>=required){
+        return tick;
+      }
+    }
+  }
+  return max_time;
+}
+
+/*******************************************************************
+ *void compact_memory()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It slides all live memory locations towards start of memory keeping their
+ *             order, so all free memory forms one hole at the end. Every moved location
+ *             is charged move_cost to compaction time.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void compact_memory(){
+  int i,live=0,moved=0;
+  for(i=0;i<memory_size;i++){
+    if(memory_location[i]!=0){
+      if(i!=live){
+        memory_location[live]=memory_location[i];
+        moved++;
+      }
+      live++;
+    }
+  }
+  for(i=live;i<memory_size;i++){
+    memory_location[i]=0;
+  }
+  if(use_bitmap){
+    if(live>0){
+      bitmap_mark(0, live-1, 0);
+    }
+    if(live<memory_size){
+      bitmap_mark(live, memory_size-1, 1);
+    }
+  }
+  compactions++;
+  moved_locations+=moved;
+  compaction_time+=moved*move_cost;
+}
+
 /*******************************************************************
  *void allocate_memory(struct Process process, char allocation_type[])
  *Author: Prashant Yadav
@@ -196,30 +577,47 @@ void complete_queued_process(){
  *int O/P: return 0 if memory is not available otherwise return 1
  *******************************************************************/
 int allocate_memory(struct Process process, char allocation_type[]){
-  int i,start=0,end=0;
+  int start=0,end=0,found;
   time_taken++;
   update_memory_location();  //Update memory_locations array before allocating.
-  for(i=0;i<56;i++){      //Loop to find first instance where required memory is available.
-    if(memory_location[i]==0){
-      end++;
-      start = memory_location[start]!=0?i:start;
+  int dynamic = strcmp(allocation_type, DYNM_MEM_ALLOC)==0;
+  int total_free, largest_hole;
+  if(dynamic && compact_threshold>0){   //Compact proactively when memory is too fragmented
+    memory_free_stats(&total_free, &largest_hole);
+    if(total_free>0 && 1.0-(double)largest_hole/total_free>compact_threshold){
+      compact_memory();
+      proactive_compactions++;
     }
-    else{
-      end=i;
-      start=i;
-    }
-    if((end-start+1)>=process.memory_required){
-          break;
+  }
+  if(search_benchmark){
+    benchmark_hole_search(process.memory_required);
+  }
+  if(use_bitmap){
+    found = find_hole_bitmap(process.memory_required, &start, &end);
+  }else{
+    found = find_hole_scan(process.memory_required, &start, &end);
+  }
+  if(!found && dynamic && compact_on_demand){  //Enough free memory but no hole, compact it
+    memory_free_stats(&total_free, &largest_hole);
+    if(total_free>=process.memory_required){
+      drain_time_saved += drain_time_estimate(process.memory_required);
+      compact_memory();
+      start = memory_size-total_free;
+      end = start+process.memory_required-1;
+      found = 1;
     }
   }
-  if((end-start+1)>=process.memory_required){   //If memory is available
+  if(found){   //If memory is available
     if(strcmp(allocation_type, STATIC_MEM_ALLOC)==0){  //Checks to find type of memory allocation
-      allocate_static_fixed_mem(start, end, process);
+      end = allocate_static_fixed_mem(start, end, process);
     }
     else if(strcmp(allocation_type, STATIC_UNEQL_MEM_ALLOC)==0){
-      allocate_static_var_mem(start, end, process);
+      end = allocate_static_var_mem(start, end, process);
     }else{
-      allocate_dynamic_mem(start, end, process);
+      end = allocate_dynamic_mem(start, end, process);
+    }
+    if(use_bitmap){
+      bitmap_mark(start, end, 0);  //Allocated locations are no longer free
     }
      return 1;   //return 1 if memory allocation is possible
   }
@@ -232,42 +630,958 @@ int allocate_memory(struct Process process, char allocation_type[]){
  *Author: Prashant Yadav
  *Date: 10/13/2019
  *Description: This routine simulates memory allocation for 1000 process for given
- *             memory allocation type.
+ *             memory allocation type. With ci_width it stops before simulations once confidence
+ *             interval of time taken is narrow enough.
  *Parameters:
  *char allocation_type[] I/P: Type of memory allocation.
  *This routine does not return anything.
  *******************************************************************/
 void simulate_memory_allocation(char allocation_type[]){
   struct Process process;
-  srand(time(0));  //Seed to given random value for each execution
-  int i,isAllocated=1,j,simulation_time=0;
-    for(j=0;j<SIMULATIONS;j++){
-      for(i=0;i<TOTAL_PROCESS;i++){
+  prng_seed(&rng, seed);  //Same seed for each allocation type, so all types see same processes
+  int i,isAllocated=1,simulation_time=0;
+  struct welford cell;
+  memset(&cell, 0, sizeof(cell));
+  allocated_processes=0;
+    for(runs=0;runs<simulations;){
+      for(i=0;i<total_process;i++){
         if(isAllocated==1){
-          process.time_required = 1 + (rand()%10);  //Randomly initialize time requirement
-          process.memory_required = 1 + (rand()%15);//Randomly initialize memory requirement
+          process.time_required = 1 + prng_bounded(&rng, 10);  //Randomly initialize time requirement
+          process.memory_required = 1 + prng_bounded(&rng, 15);//Randomly initialize memory requirement
         }
         isAllocated=allocate_memory(process, allocation_type);
+        allocated_processes+=isAllocated;
       }
       complete_queued_process();
       simulation_time+=time_taken;
+      welford_add(&cell, time_taken);
       reset_time_counter();
+      runs++;
+      if(ci_width>0 && ci_converged(cell.mean, ci_half_width(welford_stddev(&cell),cell.n), cell.n, min_runs, ci_width)){
+        break;
+      }
+   }
+   total_runs+=runs;
+   simulation_time+=(int)(compaction_time+0.5);   //Compaction stops the world, charge its time
+   printf("Time taken for %s is %.2f\n",allocation_type,(float)simulation_time/runs);
+   if(ci_width>0){
+     printf("Simulations run %d of %d, 95%% CI half width %.2f\n",runs,simulations,
+            ci_half_width(welford_stddev(&cell),cell.n));
    }
-   printf("Time taken for %s is %.2f\n",allocation_type,(float)simulation_time/SIMULATIONS);
 }
 
 /*******************************************************************
- *void main()
+ *void print_compaction_stats()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints compaction runs, moved locations, time charged for compaction,
+ *             drain time saved and processes allocated per simulation and resets counters.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void print_compaction_stats(){
+  if(compactions==0){
+    return;
+  }
+  double cost = compaction_time/runs;
+  double saved = (double)drain_time_saved/runs;
+  printf("Compaction: %.2f runs (%.2f proactive), %.2f locations moved, time %.2f, drain time saved %.2f, net %.2f per simulation\n",
+         (double)compactions/runs, (double)proactive_compactions/runs,
+         (double)moved_locations/runs, cost, saved, saved-cost);
+  printf("Processes allocated per simulation %.2f\n",(double)allocated_processes/runs);
+  compactions=0;
+  proactive_compactions=0;
+  moved_locations=0;
+  drain_time_saved=0;
+  compaction_time=0;
+}
+
+/*******************************************************************
+ *void print_search_latency()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints average hole search latency of scan and bitmap search and
+ *             resets latency counters for next allocation type.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void print_search_latency(){
+  if(search_count==0){
+    return;
+  }
+  double scan_ns = (double)scan_search_ns/search_count;
+  double bitmap_ns = (double)bitmap_search_ns/search_count;
+  printf("Hole search latency: scan %.1f ns, bitmap %.1f ns, speedup %.2fx\n",
+         scan_ns, bitmap_ns, bitmap_ns>0?scan_ns/bitmap_ns:0);
+  scan_search_ns=0;
+  bitmap_search_ns=0;
+  search_count=0;
+}
+
+/*******************************************************************
+ *int block_start(char allocation_type[], int pos)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns first block boundary at or after pos for static allocation, pos
+ *             itself for dynamic allocation. Unequal blocks repeat every 56 locations.
+ *Parameters:
+ *char allocation_type[] I/P: Type of memory allocation.
+ *int pos I/P: Memory location.
+ *int O/P: It returns memory location where a block starts.
+ *******************************************************************/
+int block_start(char allocation_type[], int pos){
+  static const int starts[8] = {0,2,6,12,20,28,40,56};
+  int i;
+  if(strcmp(allocation_type, STATIC_MEM_ALLOC)==0){
+    return (pos+7)/8*8;
+  }
+  if(strcmp(allocation_type, STATIC_UNEQL_MEM_ALLOC)==0){
+    for(i=0;starts[i]<pos%56;i++);
+    return pos-pos%56+starts[i];
+  }
+  return pos;
+}
+
+/*******************************************************************
+ *int bitmap_next_run(int from, int limit, int *start, int *end)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds first run of free locations starting at or after from and before
+ *             limit, skipping used words with summary bits and free words whole.
+ *Parameters:
+ *int from I/P: First location to look at.
+ *int limit I/P: Locations from limit on are not looked at.
+ *int *start O/P: First location of run.
+ *int *end O/P: Last location of run, below limit.
+ *int O/P: It returns 1 if a run is found otherwise 0.
+ *******************************************************************/
+int bitmap_next_run(int from, int limit, int *start, int *end){
+  int w = from>>6;
+  unsigned long long word;
+  if(from>=limit){
+    return 0;
+  }
+  word = free_bitmap[w] & (~0ULL<<(from&63));
+  while(word==0){   //Skip used words, whole summary words at a time
+    w++;
+    while(w<bitmap_words && (w&63)==0 && free_summary[w>>6]==0){
+      w += 64;
+    }
+    if(w>=bitmap_words || (w<<6)>=limit){
+      return 0;
+    }
+    word = free_bitmap[w];
+  }
+  *start = (w<<6)+__builtin_ctzll(word);
+  if(*start>=limit){
+    return 0;
+  }
+  word = ~free_bitmap[w] & (~0ULL<<(*start&63));
+  while(word==0 && ++w<bitmap_words && (w<<6)<limit){
+    word = ~free_bitmap[w];
+  }
+  *end = word!=0?(w<<6)+__builtin_ctzll(word)-1:limit-1;
+  *end = *end<limit?*end:limit-1;
+  return 1;
+}
+
+/*******************************************************************
+ *int bitmap_used_top(int end)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds last used memory location at or below end in free-space bitmap,
+ *             a word at a time from end downwards.
+ *Parameters:
+ *int end I/P: Highest memory location to look at.
+ *int O/P: It returns 1 past last used location, 0 when all of them are free.
+ *******************************************************************/
+int bitmap_used_top(int end){
+  int w;
+  for(w=end>>6;w>=0;w--){
+    unsigned long long used = ~free_bitmap[w];
+    if(w==end>>6 && ((end+1)&63)!=0){
+      used &= (1ULL<<((end+1)&63))-1;
+    }
+    if(used!=0){
+      return (w<<6)+64-__builtin_clzll(used);
+    }
+  }
+  return 0;
+}
+
+/*******************************************************************
+ *int trace_find_hole(int required, char allocation_type[], int fit, int *start, int *end)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds place for an allocation of a trace. Static allocation takes whole
+ *             blocks, so place starts at a block boundary and ends at end of a block. First
+ *             fit takes lowest place, next fit lowest place after previous allocation and
+ *             then wraps around up to end of free run at that place, best fit the smallest
+ *             free run which is large enough. Memory
+ *             above heap top is free, so runs are only followed a little past it and a run
+ *             reaching that far counts as all memory above it.
+ *Parameters:
+ *int required I/P: Number of memory locations required.
+ *char allocation_type[] I/P: Type of memory allocation.
+ *int fit I/P: FIT_FIRST, FIT_NEXT or FIT_BEST.
+ *int *start O/P: First location of place.
+ *int *end O/P: Last location of place, end of its last block for static allocation.
+ *int O/P: It returns 1 if place is found otherwise 0.
+ *******************************************************************/
+int trace_find_hole(int required, char allocation_type[], int fit, int *start, int *end){
+  int from = fit==FIT_NEXT?next_fit:0, wrapped = 0;
+  int top = from>heap_top?from:heap_top;   //Everything from here up is free
+  int top_limit = top+required+64<memory_size?top+required+64:memory_size, limit = top_limit;
+  int run_start, run_end, best_len = -1;
+  while(1){
+    if(!bitmap_next_run(from, limit, &run_start, &run_end)){
+      if(fit!=FIT_NEXT || wrapped || next_fit==0){
+        break;
+      }
+      wrapped = 1;   //Next fit goes around once, up to where it started
+      limit = next_fit;
+      if(bitmap_next_run(next_fit, top_limit, &run_start, &run_end) && run_start==next_fit){
+        limit = run_end+1;   //A run reaching across next fit is seen whole
+      }
+      from = 0;
+      continue;
+    }
+    from = run_end+1;
+    if(fit==FIT_BEST){
+      int len = run_end==top_limit-1?memory_size-run_start:run_end-run_start+1;
+      if(len>=required && (best_len<0 || len<best_len)){
+        best_len = len;
+        *start = run_start;
+        if(len==required){
+          break;
+        }
+      }
+      continue;
+    }
+    int s = block_start(allocation_type, run_start);
+    if(s+required-1<=run_end){
+      int e = block_start(allocation_type, s+required)-1;   //Up to end of last block
+      if(e<=run_end){
+        *start = s;
+        *end = e;
+        return 1;
+      }
+    }
+  }
+  if(best_len<0){
+    return 0;
+  }
+  *end = *start+required-1;
+  return 1;
+}
+
+/*******************************************************************
+ *struct live_block *live_find(unsigned long long id)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds slot of an allocation in live table, open addressing with linear
+ *             probing, or the empty slot where it would go.
+ *Parameters:
+ *unsigned long long id I/P: Allocation id of trace.
+ *struct live_block * O/P: It returns slot, start is -1 when id is not live.
+ *******************************************************************/
+struct live_block *live_find(unsigned long long id){
+  unsigned int i = (unsigned int)((id*0x9e3779b97f4a7c15ULL)>>32)&(live_capacity-1);
+  while(live_table[i].start>=0 && live_table[i].id!=id){
+    i = (i+1)&(live_capacity-1);
+  }
+  return &live_table[i];
+}
+
+/*******************************************************************
+ *void live_insert(unsigned long long id, int start, int end)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It records a live allocation. Table doubles when it is half full, so it only
+ *             grows with live allocations, not with trace length.
+ *Parameters:
+ *unsigned long long id I/P: Allocation id of trace.
+ *int start I/P: First location of allocation.
+ *int end I/P: Last location of allocation.
+ *This routine does not return anything.
+ *******************************************************************/
+void live_insert(unsigned long long id, int start, int end){
+  int i;
+  if(2*(live_count+1)>live_capacity){
+    struct live_block *old = live_table;
+    int old_capacity = live_capacity;
+    live_capacity = 2*old_capacity;
+    live_table = (struct live_block*)malloc(live_capacity*sizeof(struct live_block));
+    for(i=0;i<live_capacity;i++){
+      live_table[i].start = -1;
+    }
+    for(i=0;i<old_capacity;i++){
+      if(old[i].start>=0){
+        *live_find(old[i].id) = old[i];
+      }
+    }
+    free(old);
+  }
+  struct live_block *b = live_find(id);
+  live_count += b->start<0;   //Id already live only gets new place
+  b->id = id;
+  b->start = start;
+  b->end = end;
+}
+
+/*******************************************************************
+ *void live_remove(struct live_block *b)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It removes an allocation from live table. Following entries of its probe run
+ *             are shifted back, so lookups need no tombstones.
+ *Parameters:
+ *struct live_block *b I/P: Slot of allocation.
+ *This routine does not return anything.
+ *******************************************************************/
+void live_remove(struct live_block *b){
+  unsigned int hole = (unsigned int)(b-live_table), i = hole;
+  while(1){
+    i = (i+1)&(live_capacity-1);
+    if(live_table[i].start<0){
+      break;
+    }
+    unsigned int home = (unsigned int)((live_table[i].id*0x9e3779b97f4a7c15ULL)>>32)&(live_capacity-1);
+    if(((i-home)&(live_capacity-1))>=((i-hole)&(live_capacity-1))){   //Entry may move back to hole
+      live_table[hole] = live_table[i];
+      hole = i;
+    }
+  }
+  live_table[hole].start = -1;
+  live_count--;
+}
+
+/*******************************************************************
+ *double trace_fragmentation()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns fragmentation of heap below its top, 1 less largest hole divided by
+ *             free memory, 0 when heap has no hole.
+ *Parameters:
+ *This routine does not take any argument.
+ *double O/P: It returns fragmentation between 0 and 1.
+ *******************************************************************/
+double trace_fragmentation(){
+  int from=0, start, end, largest=0, total=0;
+  while(bitmap_next_run(from, heap_top, &start, &end)){
+    total += end-start+1;
+    largest = end-start+1>largest?end-start+1:largest;
+    from = end+1;
+  }
+  return total>0?1.0-(double)largest/total:0;
+}
+
+/*******************************************************************
+ *void trace_sample(long long time)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It adds a point of heap top, live memory and fragmentation to time series.
+ *             When series is full neighbouring points are merged and points are taken half
+ *             as often, so series covers whole trace in SERIES_POINTS points at most.
+ *Parameters:
+ *long long time I/P: Trace time of point.
+ *This routine does not return anything.
+ *******************************************************************/
+void trace_sample(long long time){
+  int i;
+  if(series_count==SERIES_POINTS){
+    for(i=0;i<SERIES_POINTS/2;i++){
+      struct series_point *a = &series[2*i], *b = &series[2*i+1];
+      series[i].time = b->time;
+      series[i].top = a->top>b->top?a->top:b->top;
+      series[i].live = (a->live+b->live)/2;
+      series[i].fragmentation = (a->fragmentation+b->fragmentation)/2;
+    }
+    series_count = SERIES_POINTS/2;
+    series_every *= 2;
+  }
+  series[series_count].time = time;
+  series[series_count].top = heap_top;
+  series[series_count].live = live_locations;
+  series[series_count].fragmentation = trace_fragmentation();
+  series_count++;
+}
+
+/*******************************************************************
+ *void replay_trace(char allocation_type[], int fit)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It replays allocation trace with one allocation type and fit. Trace is read a
+ *             line at a time and only live allocations are kept, so memory does not grow
+ *             with trace. Lines are "time a id bytes" for malloc, "time f id" for free and
+ *             "time r id bytes" for realloc, which frees and allocates again. Malloc of an id
+ *             which is still live is replayed as realloc. Lines starting with # are comments. Sizes are rounded up to whole memory locations of
+ *             trace_unit bytes. Prints replay rate, failed allocations, peak heap top and
+ *             fragmentation over time.
+ *Parameters:
+ *char allocation_type[] I/P: Type of memory allocation.
+ *int fit I/P: FIT_FIRST, FIT_NEXT or FIT_BEST.
+ *This routine does not return anything.
+ *******************************************************************/
+void replay_trace(char allocation_type[], int fit){
+  static const char *fit_names[] = {"first fit","next fit","best fit"};
+  char line[256];
+  long long events=0, allocations=0, frees=0, failed=0, bad_frees=0, reused=0, time=0;
+  int i, peak=0;
+  double fragmentation=0;
+  struct timespec t0,t1;
+  FILE *file = fopen(trace_path, "r");
+  if(file==NULL){
+    printf("Can not open trace %s\n",trace_path);
+    exit(1);
+  }
+  clear_memory();
+  if(live_table==NULL){
+    live_capacity = 1024;
+    live_table = (struct live_block*)malloc(live_capacity*sizeof(struct live_block));
+  }
+  for(i=0;i<live_capacity;i++){
+    live_table[i].start = -1;
+  }
+  live_count = 0;
+  live_locations = 0;
+  heap_top = 0;
+  next_fit = 0;
+  series_count = 0;
+  series_every = 256;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  while(fgets(line, sizeof(line), file)!=NULL){
+    char *p = line, op;
+    unsigned long long id, bytes=0;
+    if(line[0]=='#'){
+      continue;
+    }
+    time = strtoll(p, &p, 10);
+    while(*p==' ' || *p=='\t'){
+      p++;
+    }
+    op = *p++;
+    id = strtoull(p, &p, 10);
+    if(op=='a' || op=='r'){
+      bytes = strtoull(p, &p, 10);
+    }else if(op!='f'){
+      continue;   //Not an event
+    }
+    events++;
+    struct live_block *b = live_find(id);
+    if(op=='a' && b->start>=0){   //Id still live, its free is missing from trace, so it is a realloc
+      reused++;
+      op = 'r';
+    }
+    if(op=='f' || op=='r'){
+      if(b->start<0){
+        bad_frees += op=='f';
+      }else{
+        int end = b->end;
+        for(i=b->start;i<=end;i++){
+          memory_location[i] = 0;
+        }
+        bitmap_mark(b->start, end, 1);
+        live_locations -= end-b->start+1;
+        live_remove(b);
+        frees++;
+        if(end+1==heap_top){   //Top block freed, heap top drops to last used location
+          heap_top = bitmap_used_top(end);
+        }
+      }
+    }
+    if(op=='a' || op=='r'){
+      int start, end, required = (int)((bytes+trace_unit-1)/trace_unit);
+      required = required<1?1:required;
+      allocations++;
+      if(required>memory_size || !trace_find_hole(required, allocation_type, fit, &start, &end)){
+        failed++;
+      }else{
+        for(i=start;i<=end;i++){
+          memory_location[i] = 1;
+        }
+        bitmap_mark(start, end, 0);
+        live_insert(id, start, end);
+        live_locations += end-start+1;
+        heap_top = end+1>heap_top?end+1:heap_top;
+        peak = heap_top>peak?heap_top:peak;
+        next_fit = end+1<memory_size?end+1:0;
+      }
+    }
+    if(events%series_every==0){
+      trace_sample(time);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  fclose(file);
+  trace_sample(time);
+  for(i=0;i<series_count;i++){
+    fragmentation += series[i].fragmentation;
+  }
+  double seconds = (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)/1e9;
+  trace_events += events;
+  printf("%s, %s: %lld events, %lld allocations (%lld failed, %lld of live ids), %lld frees (%lld unknown), %.2f M events/s\n",
+         allocation_type,fit_names[fit],events,allocations,failed,reused,frees,bad_frees,seconds>0?events/seconds/1e6:0);
+  printf("Peak footprint %d locations (%lld bytes), mean fragmentation %.4f\n",peak,(long long)peak*trace_unit,
+         series_count>0?fragmentation/series_count:0);
+  printf("Time\t\tFootprint\tLive\t\tFragmentation\n");
+  for(i=0;i<series_count;i++){
+    printf("%-12lld\t%-12d\t%-12d\t%.4f\n",series[i].time,series[i].top,series[i].live,series[i].fragmentation);
+  }
+}
+
+/*******************************************************************
+ *void heap_acquire(struct thread_heap *h)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It takes heap lock for a thread. An acquisition which finds lock held is
+ *             counted as contended and time spent waiting for it is added to thread stats.
+ *Parameters:
+ *struct thread_heap *h I/P: Heap state of acquiring thread.
+ *This routine does not return anything.
+ *******************************************************************/
+void heap_acquire(struct thread_heap *h){
+  h->acquisitions++;
+  if(pthread_mutex_trylock(&heap_lock)!=0){
+    struct timespec t0,t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    pthread_mutex_lock(&heap_lock);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    h->contended++;
+    h->wait_ns += (t1.tv_sec-t0.tv_sec)*1000000000LL+(t1.tv_nsec-t0.tv_nsec);
+  }
+}
+
+/*******************************************************************
+ *int size_class(int required)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns size class of an allocation, class c holds blocks of 2^c locations.
+ *Parameters:
+ *int required I/P: Number of memory locations required, 1 to 64.
+ *int O/P: It returns smallest class whose blocks fit required locations.
+ *******************************************************************/
+int size_class(int required){
+  return required<=1?0:32-__builtin_clz(required-1);
+}
+
+/*******************************************************************
+ *int central_refill(struct thread_heap *h, int c)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It moves up to cache_batch blocks of a size class into thread cache under heap
+ *             lock, first from central pool and then carved from free memory. Carving asks
+ *             for all missing blocks as one run and halves the run while no hole fits it.
+ *Parameters:
+ *struct thread_heap *h I/P: Heap state of thread.
+ *int c I/P: Size class.
+ *int O/P: It returns number of blocks moved into cache.
+ *******************************************************************/
+int central_refill(struct thread_heap *h, int c){
+  int got=0, k;
+  heap_acquire(h);
+  while(got<cache_batch && central_count[c]>0){
+    h->cache[c][h->cache_count[c]++] = central_blocks[c][--central_count[c]];
+    got++;
+  }
+  while(got<cache_batch){
+    int blocks = cache_batch-got, start, end;
+    while(blocks>0 && !find_hole_bitmap(blocks<<c, &start, &end)){
+      blocks >>= 1;
+    }
+    if(blocks==0){
+      break;
+    }
+    bitmap_mark(start, end, 0);
+    for(k=blocks-1;k>=0;k--){   //Lowest block is taken first
+      h->cache[c][h->cache_count[c]++] = start+(k<<c);
+    }
+    got += blocks;
+  }
+  pthread_mutex_unlock(&heap_lock);
+  return got;
+}
+
+/*******************************************************************
+ *void central_return(struct thread_heap *h, int c)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It moves cache_batch blocks of a full thread cache back to central pool under
+ *             heap lock. Returned blocks stay carved, so they remain in their size class.
+ *Parameters:
+ *struct thread_heap *h I/P: Heap state of thread.
+ *int c I/P: Size class.
+ *This routine does not return anything.
+ *******************************************************************/
+void central_return(struct thread_heap *h, int c){
+  int k;
+  heap_acquire(h);
+  if(central_count[c]+cache_batch>central_capacity[c]){
+    central_capacity[c] = 2*(central_capacity[c]+cache_batch);
+    central_blocks[c] = (int*)realloc(central_blocks[c], central_capacity[c]*sizeof(int));
+  }
+  for(k=0;k<cache_batch;k++){
+    central_blocks[c][central_count[c]++] = h->cache[c][--h->cache_count[c]];
+  }
+  pthread_mutex_unlock(&heap_lock);
+}
+
+/*******************************************************************
+ *int thread_alloc(struct thread_heap *h, int required, int *start)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It allocates memory for a thread. With global lock every allocation does first
+ *             fit bitmap search under heap lock. With thread cache it takes a block of size
+ *             class from thread cache, refilling cache from central pool when it is empty.
+ *Parameters:
+ *struct thread_heap *h I/P: Heap state of thread.
+ *int required I/P: Number of memory locations required.
+ *int *start O/P: First location of allocation.
+ *int O/P: It returns 1 if memory is allocated otherwise 0.
+ *******************************************************************/
+int thread_alloc(struct thread_heap *h, int required, int *start){
+  int end, found;
+  if(h->mode==MODE_GLOBAL){
+    heap_acquire(h);
+    found = find_hole_bitmap(required, start, &end);
+    if(found){
+      bitmap_mark(*start, end, 0);
+    }
+    pthread_mutex_unlock(&heap_lock);
+    return found;
+  }
+  int c = size_class(required);
+  if(h->cache_count[c]==0 && central_refill(h, c)==0){
+    return 0;
+  }
+  *start = h->cache[c][--h->cache_count[c]];
+  return 1;
+}
+
+/*******************************************************************
+ *void thread_free(struct thread_heap *h, int start, int required)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It frees memory of a thread, into free memory under heap lock with global lock
+ *             or into thread cache, which gives a batch back to central pool when full.
+ *Parameters:
+ *struct thread_heap *h I/P: Heap state of thread.
+ *int start I/P: First location of allocation.
+ *int required I/P: Number of memory locations allocated.
+ *This routine does not return anything.
+ *******************************************************************/
+void thread_free(struct thread_heap *h, int start, int required){
+  if(h->mode==MODE_GLOBAL){
+    heap_acquire(h);
+    bitmap_mark(start, start+required-1, 1);
+    pthread_mutex_unlock(&heap_lock);
+    return;
+  }
+  int c = size_class(required);
+  h->cache[c][h->cache_count[c]++] = start;
+  if(h->cache_count[c]==2*cache_batch){
+    central_return(h, c);
+  }
+}
+
+/*******************************************************************
+ *void *allocator_worker(void *arg)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It runs thread_ops allocations and frees of one thread. A thread holds at most
+ *             MAX_LIVE allocations and allocates or frees a random one with equal chance.
+ *             Sizes are 1 to 64 locations, small ones more likely. Allocated memory is
+ *             written with thread number and cleared again when freed.
+ *Parameters:
+ *void *arg I/P: Heap state of thread.
+ *void * O/P: It returns NULL.
+ *******************************************************************/
+void *allocator_worker(void *arg){
+  struct thread_heap *h = (struct thread_heap*)arg;
+  long long op;
+  int i;
+  for(op=0;op<thread_ops;op++){
+    if(h->live_count==0 || (h->live_count<MAX_LIVE && prng_bounded(&h->rng, 2)==0)){
+      int start, required = 1+prng_bounded(&h->rng, 1+prng_bounded(&h->rng, 64));
+      if(!thread_alloc(h, required, &start)){
+        h->failed++;
+        continue;
+      }
+      for(i=0;i<required;i++){
+        memory_location[start+i] = h->id+1;
+      }
+      h->live_start[h->live_count] = start;
+      h->live_size[h->live_count++] = required;
+      h->live_locations += required;
+      h->allocations++;
+    }else{
+      int k = prng_bounded(&h->rng, h->live_count);
+      int start = h->live_start[k], required = h->live_size[k];
+      for(i=0;i<required;i++){
+        memory_location[start+i] = 0;
+      }
+      thread_free(h, start, required);
+      h->live_start[k] = h->live_start[--h->live_count];
+      h->live_size[k] = h->live_size[h->live_count];
+      h->live_locations -= required;
+      h->frees++;
+    }
+  }
+  return NULL;
+}
+
+/*******************************************************************
+ *void run_concurrent(int threads, int mode)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It runs allocator threads on empty memory and prints allocation rate, lock
+ *             contention and fragmentation when they are done. Internal fragmentation is
+ *             share of memory taken from free memory which holds no live allocation, i.e.
+ *             size class rounding and blocks sitting in caches and central pool. External
+ *             fragmentation is that of holes below heap top, as for traces. Wait time is
+ *             summed over threads.
+ *Parameters:
+ *int threads I/P: Number of threads.
+ *int mode I/P: MODE_GLOBAL or MODE_CACHE.
+ *This routine does not return anything.
+ *******************************************************************/
+void run_concurrent(int threads, int mode){
+  static const char *mode_names[] = {"global lock","thread cache"};
+  pthread_t workers[MAX_THREADS];
+  struct timespec t0,t1;
+  long long allocations=0, frees=0, failed=0, acquisitions=0, contended=0, wait_ns=0, live=0;
+  int i,c,held=memory_size;
+  clear_memory();
+  for(c=0;c<SIZE_CLASSES;c++){
+    central_count[c] = 0;
+  }
+  for(i=0;i<threads;i++){
+    struct thread_heap *h = &thread_heaps[i];
+    int *cache[SIZE_CLASSES];
+    memcpy(cache, h->cache, sizeof(cache));
+    memset(h, 0, sizeof(*h));
+    memcpy(h->cache, cache, sizeof(cache));
+    prng_stream(&h->rng, seed+11, i);   //Same streams for both modes
+    h->id = i;
+    h->mode = mode;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(i=0;i<threads;i++){
+    pthread_create(&workers[i], NULL, allocator_worker, &thread_heaps[i]);
+  }
+  for(i=0;i<threads;i++){
+    pthread_join(workers[i], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  for(i=0;i<threads;i++){
+    struct thread_heap *h = &thread_heaps[i];
+    allocations += h->allocations;
+    frees += h->frees;
+    failed += h->failed;
+    acquisitions += h->acquisitions;
+    contended += h->contended;
+    wait_ns += h->wait_ns;
+    live += h->live_locations;
+  }
+  for(i=0;i<bitmap_words;i++){
+    held -= __builtin_popcountll(free_bitmap[i]);
+  }
+  heap_top = bitmap_used_top(memory_size-1);
+  concurrent_ops += allocations+frees;
+  double seconds = (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)/1e9;
+  printf("%-8d%-16s%-14.0f%-10.3f%-11.2f%-12.2f%-10.4f%-10.4f%lld\n",threads,mode_names[mode],
+         seconds>0?allocations/seconds:0,allocations+frees>0?(double)acquisitions/(allocations+frees):0,
+         acquisitions>0?100.0*contended/acquisitions:0,wait_ns/1e6,held>0?1.0-(double)live/held:0,
+         trace_fragmentation(),failed);
+}
+
+/*******************************************************************
+ *void simulate_concurrent()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It runs concurrent allocator with 1, 2, 4, ... threads up to concurrent_threads,
+ *             each count first with global lock and then with thread caches.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void simulate_concurrent(){
+  int threads,i,c;
+  thread_heaps = (struct thread_heap*)aligned_alloc(64, concurrent_threads*sizeof(struct thread_heap));
+  for(i=0;i<concurrent_threads;i++){
+    for(c=0;c<SIZE_CLASSES;c++){
+      thread_heaps[i].cache[c] = (int*)malloc(2*cache_batch*sizeof(int));
+    }
+  }
+  printf("Concurrent allocator, %lld operations per thread, batch %d, %d memory locations\n",
+         thread_ops,cache_batch,memory_size);
+  printf("Threads Mode            Allocs/s      Locks/op  Contended%% Wait ms     Internal  External  Failed\n");
+  for(threads=1;;threads=2*threads<concurrent_threads?2*threads:concurrent_threads){
+    run_concurrent(threads, MODE_GLOBAL);
+    run_concurrent(threads, MODE_CACHE);
+    if(threads==concurrent_threads){
+      break;
+    }
+  }
+}
+
+/*******************************************************************
+ *void parse_arguments(int argc, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It parses command line options.
+ *             --memory N     Number of memory locations (default 56).
+ *             --bitmap       Use free-space bitmap for hole search.
+ *             --search-bench Measure latency of scan and bitmap hole search.
+ *             --compact      Compact memory when dynamic allocation finds no hole.
+ *             --compact-threshold F  Compact when fragmentation exceeds F (0..1).
+ *             --move-cost C  Modeled time to move one memory location (default 0.1).
+ *             --seed N       Seed of random number stream (default current time).
+ *             --simulations N  Simulations for each allocation type (default 1000), upper bound
+ *                            with --ci-width.
+ *             --ci-width R   Stop an allocation type once 95% confidence interval half width of
+ *                            time taken is within R times its mean (default 0, fixed count).
+ *             --min-runs N   Fewest simulations with --ci-width (default 10).
+ *             --processes N  Processes generated in each simulation (default 1000).
+ *             --trace FILE   Replay malloc and free trace with every allocation type, dynamic
+ *                            allocation by first, next and best fit.
+ *             --unit N       Bytes in a memory location for trace (default 16), heap is
+ *                            --memory locations, 1048576 by default.
+ *             --concurrent N Run allocator with 1, 2, 4, ... up to N threads (1 to 64), with global
+ *                            lock and with thread caches, heap is 1048576 locations unless
+ *                            --memory is given.
+ *             --ops N        Allocations and frees of each thread (default 20000).
+ *             --cache-batch N  Blocks moved between thread cache and central pool (default 16).
+ *             --bench        Print operation count at end.
+ *Parameters:
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments.
+ *This routine does not return anything.
+ *******************************************************************/
+void parse_arguments(int argc, char *argv[]){
+  int i;
+  seed = (uint64_t)time(0);
+  for(i=1;i<argc;i++){
+    if(strcmp(argv[i],"--memory")==0 && i+1<argc){
+      memory_size = atoi(argv[++i]);
+      memory_given = 1;
+    }else if(strcmp(argv[i],"--trace")==0 && i+1<argc){
+      trace_path = argv[++i];
+    }else if(strcmp(argv[i],"--unit")==0 && i+1<argc){
+      trace_unit = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--concurrent")==0 && i+1<argc){
+      concurrent_threads = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--ops")==0 && i+1<argc){
+      thread_ops = atoll(argv[++i]);
+    }else if(strcmp(argv[i],"--cache-batch")==0 && i+1<argc){
+      cache_batch = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--bitmap")==0){
+      use_bitmap = 1;
+    }else if(strcmp(argv[i],"--search-bench")==0){
+      search_benchmark = 1;
+      use_bitmap = 1;   //Bitmap has to be maintained to time bitmap search
+    }else if(strcmp(argv[i],"--compact")==0){
+      compact_on_demand = 1;
+    }else if(strcmp(argv[i],"--compact-threshold")==0 && i+1<argc){
+      compact_threshold = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--move-cost")==0 && i+1<argc){
+      move_cost = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--seed")==0 && i+1<argc){
+      seed = strtoull(argv[++i], NULL, 0);
+    }else if(strcmp(argv[i],"--simulations")==0 && i+1<argc){
+      simulations = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--processes")==0 && i+1<argc){
+      total_process = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--ci-width")==0 && i+1<argc){
+      ci_width = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--min-runs")==0 && i+1<argc){
+      min_runs = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--bench")==0){
+      bench_mode = 1;
+    }else{
+      printf("Usage: %s [--memory N] [--bitmap] [--search-bench] [--compact]\n"
+             "          [--compact-threshold F] [--move-cost C] [--seed N]\n"
+             "          [--simulations N] [--ci-width R] [--min-runs N] [--processes N]\n"
+             "          [--trace FILE] [--unit N] [--concurrent N] [--ops N] [--cache-batch N]\n"
+             "          [--bench]\n",argv[0]);
+      exit(1);
+    }
+  }
+  if(memory_size<1 || simulations<1 || total_process<1){
+    printf("Memory size, simulations and processes must be positive\n");
+    exit(1);
+  }
+  if(ci_width<0 || min_runs<2){
+    printf("Confidence interval width must not be negative and min runs at least 2\n");
+    exit(1);
+  }
+  if(trace_path!=NULL && (compact_on_demand || compact_threshold>0 || search_benchmark || ci_width>0 || trace_unit<1)){
+    printf("--trace needs positive --unit and can not be combined with compaction, --search-bench and --ci-width\n");
+    exit(1);
+  }
+  if(concurrent_threads!=0 && (concurrent_threads<1 || concurrent_threads>MAX_THREADS || thread_ops<1 ||
+     cache_batch<1 || cache_batch>1024)){
+    printf("--concurrent must be 1 to %d, --ops positive and --cache-batch 1 to 1024\n",MAX_THREADS);
+    exit(1);
+  }
+  if(concurrent_threads!=0 && (trace_path!=NULL || compact_on_demand || compact_threshold>0 || search_benchmark || ci_width>0)){
+    printf("--concurrent can not be combined with --trace, compaction, --search-bench and --ci-width\n");
+    exit(1);
+  }
+}
+
+/*******************************************************************
+ *int main(int argc, char *argv[])
  *Author: Prashant Yadav
  *Date: 10/13/2019
  *Description: This is driver routine. Program execution starts here. We call 
- *             simulate_memory_allocation with all three configurations.
+ *             simulate_memory_allocation with all three configurations, or replay a trace
+ *             or run concurrent allocator.
  *Parameters:
- *It does not take any input args.
- *This routine does not return anything.
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments, see parse_arguments.
+ *int O/P: It returns 0 on success.
  *******************************************************************/
-void main(){
+int main(int argc, char *argv[]){
+  parse_arguments(argc, argv);
+  printf("Seed %llu\n",(unsigned long long)seed);
+  if(trace_path!=NULL || concurrent_threads!=0){
+    memory_size = memory_given?memory_size:1<<20;
+    use_bitmap = 1;   //Trace and threads place allocations by free-space bitmap
+  }
+  memory_location = (int*)calloc(memory_size, sizeof(int));
+  if(use_bitmap){
+    bitmap_init();
+  }
+  if(trace_path!=NULL){
+    replay_trace(STATIC_MEM_ALLOC, FIT_FIRST);
+    replay_trace(STATIC_UNEQL_MEM_ALLOC, FIT_FIRST);
+    replay_trace(DYNM_MEM_ALLOC, FIT_FIRST);
+    replay_trace(DYNM_MEM_ALLOC, FIT_NEXT);
+    replay_trace(DYNM_MEM_ALLOC, FIT_BEST);
+    if(bench_mode){
+      printf("ops=%lld\n",trace_events);   //Trace events of all allocation types
+    }
+    return 0;
+  }
+  if(concurrent_threads!=0){
+    simulate_concurrent();
+    if(bench_mode){
+      printf("ops=%lld\n",concurrent_ops);   //Allocations and frees of all runs
+    }
+    return 0;
+  }
   simulate_memory_allocation(STATIC_MEM_ALLOC); //Simulate static memory allocation
+  print_search_latency();
   simulate_memory_allocation(STATIC_UNEQL_MEM_ALLOC); //Simulate static unequal sized block memory allocation
+  print_search_latency();
   simulate_memory_allocation(DYNM_MEM_ALLOC); //Simulate dynamic memory allocation
+  print_search_latency();
+  print_compaction_stats();
+  if(bench_mode){
+    printf("ops=%lld\n",total_runs*total_process);   //Allocation attempts of all three types
+  }
+  return 0;
 }
@@ -5,7 +5,12 @@
  *clear_cache - It accepts struct of cache type and clear all intialized memory locations.
  *initialize_cache - Before starting the simulation it initializes all four type of caches.
  *uniform - It generates numbers uniformly between given high and low values.
- *normal - it generates normally distributed numbers which are used as arbitrary memory addresses.
+ *fill_normal_addresses - Fills addresses clustered around a random base with approximately normal offsets.
+ *fill_uniform_addresses - Fills addresses uniformly distributed over all pages.
+ *build_zipf_table - Builds alias table used to draw Zipf distributed pages.
+ *fill_zipf_addresses - Fills Zipf distributed addresses.
+ *fill_phased_addresses - Fills addresses from a working set which moves at every phase.
+ *generate_address_chunk - Fills one chunk of address stream with selected workload.
  *generatePageAddresses - Before each simulation it populates address array with arbitrary memory addresses.
  *print_cache - Given a struct type cache it prints all cache location.
  *get_memory_loc - Given a struct type cache and memory address it returns memory location or null. 
@@ -13,23 +18,84 @@
  *fifo_policy_faults - It accepts working set size, it simulates memory allocation process for FIFO eviction policy and returns number of faults.
  *random_policy_faults - It accepts working set size, it simulates memory allocation process for RANDOM eviction policy and returns number of faults.
  *clock_policy_faults - It accepts working set size, it simulates memory allocation process for CLOCK eviction policy and returns number of faults.
+ *frame_table_init - Initializes an array based frame table for given policy and frame count.
+ *frame_table_reference - References a page in a frame table and evicts a frame by its policy if needed.
+ *fused_prepare - Sets up frame tables of all policies and working set sizes.
+ *fused_policy_faults - Simulates all policies and working set sizes in one pass over address stream.
+ *frame_table_clean - Writes back a batch of dirty frames in eviction order.
+ *cost_policy_faults - Simulates all policies with dirty bits and optional cleaner.
+ *printCostModel - Prints modeled time and write backs of every policy.
+ *frame_table_prefetch - Loads a batch of prefetched pages into a frame table.
+ *prefetch_pages - Picks pages to prefetch by fixed, adaptive or stride prefetcher.
+ *prefetch_policy_faults - Simulates all policies on demand only and with prefetcher.
+ *printPrefetch - Prints demand misses, prefetch hits and wasted prefetches.
+ *parse_policy - Converts policy name to policy number.
+ *tlb_lookup - Looks up a page in set associative TLB and fills it on a miss.
+ *tlb_invalidate - Drops TLB entry of an evicted page.
+ *hierarchy_faults - Simulates TLB in front of page frames.
+ *printHierarchy - Prints hit rates and average memory access time of TLB and page frames.
+ *nested_policy_faults - Simulates every policy and working set size with linked list caches.
+ *ws_prepare - Grows per page arrays of working set policies for current address stream.
+ *working_set_faults - Simulates WS(tau) for all windows in one pass.
+ *wsclock_faults - Simulates WSClock for one window.
+ *printWorkingSetPolicies - Prints faults and resident pages of WS and WSClock.
+ *local_process_faults - Thread simulating processes with local replacement.
+ *global_process_faults - Simulates processes sharing frames with global replacement.
+ *jain_index - Computes Jain fairness index of per process faults.
+ *simulate_shared_frames - Simulates several processes over a shared frame pool.
+ *printSharedFrames - Prints per process faults, frames held and fairness.
+ *mrc_init - Allocates sampled miss ratio curve estimator.
+ *mrc_reset - Empties estimator and picks new sampling hash.
+ *mrc_reference - Feeds one reference to sampled estimator.
+ *mrc_estimate - Estimates LRU, FIFO and CLOCK faults from samples.
+ *mrc_compare - Estimates faults of current stream and accumulates error against exact faults.
+ *simulate_mrc_trace - Streams a long trace through estimator and prints miss ratio curve.
+ *printMrcEstimate - Prints estimated faults and their error.
  *simulatePageFaults - This method simulates page fault process from working set size 2 to 19.
  *inializeFaultMatrix - Before starting simulations this method initiallizes fault matrix with all zeros.
  *printFaultMatrix - This routine is used to print fault matrix.
+ *printEngineTimes - Prints time spent by nested and fused engines.
  *normalizeFaultMatrix - Normalizes fault matrix for given number of experiments.
+ *cell_sample - Adds faults of one experiment to running statistics and stops converged cells.
+ *printCellRuns - Prints experiments each cell needed in adaptive mode.
+ *storedExperiment - Takes faults of an experiment from result store or simulates and stores them.
+ *parse_arguments - Parses command line options.
  *main - Driver main routine from where program starts executing. In this routine we simulate memory allocation process for 1000 experiments.
  *******************************************************************/
 #include<stdio.h>
 #include<stdlib.h>
 #include<time.h>
 #include<string.h>
+#include<math.h>
+#include<pthread.h>
+#include "../common/prng.h"
+#include "../common/stats.h"
+#include "../common/store.h"
 
 //19 rows to store faults from working set size from 2 to 19.
 //Each column stores fault size for LRU, FIFO, CLOCK, RANDOM eviction policy.
 //index0 - LRU, index1 - FIFO, index2 - CLOCK, index3 - RANDOM 
-int faults[19][4];
+long long faults[19][4];
 int experiments=1000, stream_length=1000;  //Number of experiments and address stream length
-int address[1000];
+int *address;
+int bench_mode=0;   //1 to suppress progress output and print operation count at end
+struct prng rng;    //Random number stream for addresses and RANDOM eviction
+uint64_t seed;      //Seed of the random number stream
+
+//Workloads generated by generatePageAddresses.
+#define WORKLOAD_NORMAL 0   //Phases of 100 references around base 25*uniform(0,9), offsets are sum of 5 uniform(0,5)
+#define WORKLOAD_UNIFORM 1  //Every page equally likely
+#define WORKLOAD_ZIPF 2     //Page i referenced with probability proportional to 1/(i+1)^s
+#define WORKLOAD_PHASED 3   //Uniform references inside a working set which moves every phase
+#define BULK_SIZE 1024      //Random numbers generated in one bulk call
+int workload=WORKLOAD_NORMAL;
+int page_space=250;         //Number of pages for uniform, zipf and phased workloads
+double zipf_exponent=1.0;   //Exponent s of Zipf workload
+int phase_length=100, phase_pages=25;  //References per phase and pages per phase for phased workload
+struct prng_x4 bulk_rng;    //Bulk random number streams for address generation
+uint64_t random_words[BULK_SIZE];
+uint32_t *zipf_threshold;   //Alias table for Zipf workload
+int *zipf_alias;
 
 //This structure is representation of single memory location in cache.
 struct memory_location{
@@ -49,6 +115,197 @@ struct cache{
 //These are the four variables used for each type of cache.
 struct cache lru_cache, fifo_cache, clock_cache, random_cache;
 
+//Eviction policies, same order as columns of fault matrix.
+#define POLICY_LRU 0
+#define POLICY_FIFO 1
+#define POLICY_CLOCK 2
+#define POLICY_RANDOM 3
+#define POLICIES 4
+#define WORKING_SETS 19     //Working set sizes 2 to 20
+#define INSTANCES (POLICIES*WORKING_SETS)
+#define NO_FRAME -1
+//Results of frame_table_reference.
+#define FRAME_HIT 0         //Page was resident
+#define FRAME_FILL 1        //Page loaded into a free frame
+#define FRAME_EVICT 2       //Page loaded after evicting another page, counted as fault
+
+//This structure is array based representation of a cache. Frames are indexes into arrays and
+//a page is found through slot array instead of walking a list.
+struct frame_table{
+  int policy;         //Eviction policy
+  int capacity;       //Number of frames
+  int count;          //Frames in use
+  int hand;           //Oldest frame for FIFO, clock hand for CLOCK
+  int lru_head;       //Most recently used frame for LRU
+  int lru_tail;       //Least recently used frame for LRU
+  int *page;          //Page held by each frame
+  int *prev, *next;   //LRU order of frames
+  unsigned char *use; //Use bit of each frame for CLOCK
+  int *slot;          //slot[page*stride] is frame holding page or NO_FRAME, NULL to search frames
+  int stride;
+  struct prng *rng;   //Random number stream for RANDOM
+  unsigned char *dirty;   //Dirty bit of each frame, NULL when writes are not modeled
+  int frame;          //Frame of last referenced page
+  int victim_dirty;   //1 when last evicted page was dirty
+};
+
+#define ENGINE_NESTED 0     //Linked list caches, one pass over addresses for each policy and size
+#define ENGINE_FUSED 1      //Frame tables of all policies and sizes advanced in one pass
+int engine=ENGINE_NESTED;
+int compare_engines=0;      //1 to run both engines on every address stream and compare them
+long long fused_faults[WORKING_SETS][POLICIES];  //Faults of fused engine in compare mode
+long long engine_mismatches=0;   //Deterministic policy results which differ between engines
+double nested_seconds=0, fused_seconds=0;
+struct frame_table fused_tables[INSTANCES];
+int *fused_slots, fused_slot_pages=0;  //Page major slot array shared by all fused instances
+int *fused_frames;          //Frame arrays of all fused instances
+unsigned char *fused_use;
+
+//Cost model. References are writes with probability write_ratio, frames keep dirty bits and
+//evicting a dirty frame costs a write back. Times are in nanoseconds.
+int cost_mode=0;                //1 to simulate costs next to fault matrix
+double write_ratio=0.3;
+uint64_t write_threshold;       //Reference is write when high half of random word is below it
+long long hit_cost=100, fault_cost=100000, writeback_cost=200000;
+int cleaner_interval=0;         //References between cleaner runs, 0 for no cleaner
+int cleaner_batch=4;            //Most frames cleaner writes in one run of each table
+struct prng_x4 write_rng;       //Random number streams for write flags
+struct prng cost_rng;           //RANDOM eviction stream, so cost model leaves fault matrix as is
+unsigned char *cost_writes, *cost_dirty;
+long long cost_misses[WORKING_SETS][POLICIES];   //Summed over experiments, first loads included
+long long cost_dirty_evictions[WORKING_SETS][POLICIES];
+long long cost_cleaner_writes[WORKING_SETS][POLICIES];
+
+//Prefetchers in front of every policy. A prefetched page is loaded like a referenced page but
+//keeps a flag until it is used, so misses of demand references, prefetch hits and prefetched
+//pages evicted unused are counted apart. Sums are over experiments.
+#define PREFETCH_NONE 0
+#define PREFETCH_FIXED 1        //Next readahead pages on every miss
+#define PREFETCH_ADAPTIVE 2     //Linux style readahead window which doubles on sequential use
+#define PREFETCH_STRIDE 3       //Pages along a repeated step between references
+#define MAX_READAHEAD 256
+int prefetch_mode=PREFETCH_NONE;
+int readahead=4;                //Pages of fixed and stride prefetch and first adaptive window
+int readahead_max=32;           //Largest adaptive window
+//Prefetcher state of one frame table.
+struct prefetch_state{
+  int last;                     //Previous demanded page
+  int stride, confidence;       //Last step and how many times in a row it repeated
+  int start, size, marker;      //Adaptive window and page whose use opens next window
+};
+struct prng prefetch_rng;       //RANDOM eviction stream, so prefetch leaves fault matrix as is
+unsigned char *prefetch_flags;  //Prefetched and not yet used flag of every frame
+long long prefetch_base[WORKING_SETS][POLICIES];     //Misses without prefetch
+long long prefetch_misses[WORKING_SETS][POLICIES];   //Misses of demand references with prefetch
+long long prefetch_hits[WORKING_SETS][POLICIES];
+long long prefetch_wasted[WORKING_SETS][POLICIES];
+long long prefetch_loaded[WORKING_SETS][POLICIES];
+
+//Two level hierarchy, a set associative TLB in front of page frames. TLB tags of a set are
+//packed next to each other as page+1, 0 marks an empty way.
+int hierarchy_mode=0;           //1 to simulate hierarchy next to fault matrix
+int tlb_entries=16, tlb_ways=4, tlb_sets, tlb_policy=POLICY_LRU;
+int page_frames=16, page_policy=POLICY_LRU;
+long long tlb_cost=1, walk_cost=30;     //Costs in ns of TLB lookup and page table walk
+uint32_t *tlb_tags;
+unsigned char *tlb_hand;        //Next way replaced in each set for FIFO and CLOCK
+uint64_t *tlb_use;              //Use bits of each set for CLOCK
+struct prng tlb_rng;
+struct prng page_rng;           //RANDOM eviction stream of page frames, so fault matrix stays as is
+struct frame_table hierarchy_table;
+int *hierarchy_store, *hierarchy_slot, hierarchy_pages=0;
+unsigned char *hierarchy_use;
+long long tlb_hits=0, page_hits=0, page_misses=0;
+double hierarchy_seconds=0;
+
+//Sampled miss ratio curve. A page is sampled when hash of page and salt is below mrc_threshold,
+//so all references of sampled pages are seen and reuse distances scale by 1/rate. LRU stack
+//only keeps depths which can hit in largest cache, so memory does not grow with trace.
+#define MRC_HASH_BITS 24
+#define MRC_BITMAP_BITS 65536   //Linear counting bitmap for distinct sampled pages
+#define MRC_MINI_FEWEST 2       //Sampled frames 2 frame cache of --mrc keeps, fewer make FIFO and CLOCK flat
+int mrc_mode=0;                 //1 to estimate faults from sampled stream next to exact simulation
+double mrc_rate=0.1;            //Fraction of pages sampled
+int mrc_rate_set=0;             //1 when --sample-rate is given
+long long mrc_trace_length=0;   //References of streamed trace, estimate only when positive
+int mrc_frames=20;              //Largest frame count of miss ratio curve
+uint32_t mrc_threshold;
+uint64_t mrc_salt;              //Hash salt, new for every experiment
+struct prng mrc_rng;
+int *mrc_stack, mrc_depth, mrc_stack_size;   //Truncated LRU stack of sampled pages
+long long *mrc_lru_hits;        //mrc_lru_hits[c] sampled references hitting with c frames but not c-1
+int mrc_mini_max;               //Miniature FIFO and CLOCK caches have 1 to mrc_mini_max frames
+struct frame_table *mrc_mini[2];
+long long *mrc_mini_misses[2];
+int *mrc_mini_frames;
+unsigned char *mrc_mini_use;
+uint64_t mrc_bitmap[MRC_BITMAP_BITS/64];
+long long mrc_sampled;          //Sampled references of current stream
+long long mrc_total_sampled=0, mrc_total_references=0;
+double mrc_faults[WORKING_SETS][3];     //Estimated LRU, FIFO and CLOCK faults summed over experiments
+double mrc_abs_error[3];        //Absolute error of per experiment estimates
+double mrc_seconds=0;
+
+//Working set policies in virtual time, one tick per reference. WS(tau) keeps pages used in last
+//tau ticks, WSClock replaces a page not used for tau ticks. Row w has window ws_step*(w+1).
+int ws_mode=0;                  //1 to simulate WS and WSClock next to fixed frame policies
+int ws_step=10;                 //Window of first row and step between rows
+long long ws_faults[WORKING_SETS][2];   //Faults of WS and WSClock summed over experiments
+double ws_resident[WORKING_SETS][2];    //Average resident pages summed over experiments
+int ws_pages=0;                 //Pages covered by per page arrays
+int *ws_last_use;               //Last use time of each page, NO_FRAME if not used
+int *wsclock_slot;              //Frame of each page or NO_FRAME
+int *wsclock_page, *wsclock_time;       //Page and time stamp of each WSClock frame
+unsigned char *wsclock_ref;     //Use bit of each WSClock frame
+
+//Processes sharing a pool of frames. With local replacement each process owns a fixed share
+//of frames, with global replacement a fault may evict a page of any process.
+#define MAX_PROCESSES 64
+int processes=0;                //Number of processes, 0 for single process simulation
+int shared_frames=0;            //Frames in pool, default 8 per process
+int shared_quantum=10;          //References a process makes before next one runs
+int shared_threads=1;           //Threads simulating local replacement
+//State of one process. Each is on its own cache lines, so threads do not share lines.
+struct process_state{
+  int *address;                 //Address stream, pages numbered from 0
+  int pages;                    //Pages used by stream
+  int frames;                   //Frames owned under local replacement
+  struct frame_table table;     //Frame table under local replacement
+  int *frame_store, *slot;
+  unsigned char *use;
+  struct prng rng;              //Random number stream for RANDOM eviction
+  long long local_faults[POLICIES], global_faults[POLICIES];
+  double resident[POLICIES];    //Average frames held under global replacement
+  long long held_time[POLICIES];
+  int position, held;           //Next reference and frames held in global simulation
+  long long last_change;        //Time held last changed
+} __attribute__((aligned(64)));
+struct process_state *process_states;
+struct frame_table shared_table;
+struct prng shared_rng;         //RANDOM eviction stream of shared table, apart from address stream
+int *shared_frame_store, *shared_slot, *page_offset, *page_owner, shared_pages;
+unsigned char *shared_use;
+double shared_jain[POLICIES][2];        //Jain index of local and global replacement summed over experiments
+
+//Adaptive experiment count. Every cell of fault matrix keeps running mean and variance and
+//stops sampling once its 95% confidence interval is within ci_width of its mean, experiments
+//is then only the upper bound. Both engines skip stopped cells.
+double ci_width=0;              //Target relative half width, 0 runs every cell experiments times
+int min_runs=10;                //Fewest experiments of a cell before it may stop
+struct welford cell_runs[WORKING_SETS][POLICIES];
+unsigned char cell_active[WORKING_SETS][POLICIES];   //1 while cell is sampled
+int active_cells=INSTANCES;
+int fused_active[INSTANCES];    //Fused instances of active cells
+void cell_sample(long long run[WORKING_SETS][POLICIES]);
+
+//Result store. With a store every experiment seeds its streams from seed and experiment number
+//and its fault matrix is appended to store, so an interrupted sweep resumes and a sweep with
+//more experiments or a wider confidence interval reuses experiments already simulated.
+const char *store_path=NULL;
+struct store result_store;
+long long experiment_run[WORKING_SETS][POLICIES];   //Faults of last simulated experiment
+long long stored_reused=0, stored_computed=0, reused_cells=0;
+
 /*******************************************************************
  *void clear_cache(struct cache *c)
  *Author: Prashant Yadav
@@ -59,6 +316,12 @@ struct cache lru_cache, fifo_cache, clock_cache, random_cache;
  *This routine does not return anything.
  *******************************************************************/
 void clear_cache(struct cache *c){
+  struct memory_location *temp = c->start;
+  while(temp!=NULL){   //Free locations left from previous simulation.
+    struct memory_location *next = temp->next;
+    free(temp);
+    temp = next;
+  }
   c->cache_size=0;
   c->start = (struct memory_location*)malloc(sizeof(struct memory_location));
   c->end   = (struct memory_location*)malloc(sizeof(struct memory_location));
@@ -100,49 +363,196 @@ void initialize_cache(){
  *******************************************************************/
 int uniform(int lo, int hi)
 {
-  int x, y=(hi-lo)+1,z=RAND_MAX/y;
-  while(y<=(x=(random()/z)));
-  return x+lo;
+  return lo + (int)prng_bounded(&rng, hi-lo+1);
 }
 
 /*******************************************************************
- *int normal ()
+ *void fill_normal_addresses(int *out, long long first, int n)
  *Author: Prashant Yadav
- *Date: 10/28/2019
- *Description: It geneates normal distributed random numbers which are used as a arbitrary memory address.
+ *Date: 10/19/2026
+ *Description: It fills addresses of the default workload. Every 100 references share a base
+ *             address 25*uniform(0,9) and offset is sum of five uniform(0,5) numbers. All five
+ *             numbers are cut from one 64 bit random word, 12 bits each, and scaled to 0..5
+ *             by multiply and shift.
+ *Parameters:
+ *int *out O/P: Buffer for addresses.
+ *long long first I/P: Position of out[0] in address stream, used to find phase boundaries.
+ *int n I/P: Number of addresses, at most BULK_SIZE.
+ *This routine does not return anything.
+ *******************************************************************/
+void fill_normal_addresses(int *out, long long first, int n){
+    int i,k;
+    static int base_addr;
+    prng_x4_fill(&bulk_rng, random_words, n);
+    for(i=0;i<n;i++){
+      if((first+i)%100==0){
+        base_addr = 25 * uniform(0,9);
+      }
+      uint64_t w = random_words[i];
+      int x = 0;
+      for(k=0;k<5;k++){
+        x += (int)((((w>>(12*k))&0xfff)*6)>>12);
+      }
+      out[i] = base_addr + x;
+    }
+}
+
+/*******************************************************************
+ *void fill_uniform_addresses(int *out, int n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It fills addresses uniformly distributed between 0 and page_space-1.
+ *Parameters:
+ *int *out O/P: Buffer for addresses.
+ *int n I/P: Number of addresses, at most BULK_SIZE.
+ *This routine does not return anything.
+ *******************************************************************/
+void fill_uniform_addresses(int *out, int n){
+    int i;
+    prng_x4_fill(&bulk_rng, random_words, n);
+    for(i=0;i<n;i++){
+      out[i] = (int)(((random_words[i]>>32)*(uint64_t)page_space)>>32);
+    }
+}
+
+/*******************************************************************
+ *void build_zipf_table()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It builds alias table for Zipf distribution over page_space pages. Each column
+ *             keeps its own page with probability threshold/2^32 and alias page otherwise,
+ *             so a draw takes one random word and no search.
  *Parameters:
  *This routine does not take any argument.
  *This routine does not return anything.
  *******************************************************************/
-int normal ()
-{
-    int x = 0,i;
-    for(i=0; i<5; i++ )
-    {
-	x += uniform( 0, 5 );
+void build_zipf_table(){
+    int i,n=page_space,small=0,large=0;
+    double total=0;
+    double *scaled = (double*)malloc(n*sizeof(double));
+    int *small_list = (int*)malloc(n*sizeof(int));
+    int *large_list = (int*)malloc(n*sizeof(int));
+    zipf_threshold = (uint32_t*)malloc(n*sizeof(uint32_t));
+    zipf_alias = (int*)malloc(n*sizeof(int));
+    for(i=0;i<n;i++){
+      scaled[i] = 1.0/pow(i+1, zipf_exponent);
+      total += scaled[i];
+    }
+    for(i=0;i<n;i++){
+      scaled[i] = scaled[i]*n/total;   //Average column weight is 1
+      zipf_alias[i] = i;
+      if(scaled[i]<1.0){
+        small_list[small++]=i;
+      }else{
+        large_list[large++]=i;
+      }
     }
-    return x;
+    while(small>0 && large>0){   //Fill each light column with mass of a heavy one
+      int l = small_list[--small], g = large_list[large-1];
+      zipf_threshold[l] = (uint32_t)(scaled[l]*4294967295.0);
+      zipf_alias[l] = g;
+      scaled[g] -= 1.0-scaled[l];
+      if(scaled[g]<1.0){
+        large--;
+        small_list[small++]=g;
+      }
+    }
+    while(large>0){
+      zipf_threshold[large_list[--large]] = 0xffffffffu;
+    }
+    while(small>0){   //Only left over by rounding, column is full
+      zipf_threshold[small_list[--small]] = 0xffffffffu;
+    }
+    free(scaled);
+    free(small_list);
+    free(large_list);
 }
 
 /*******************************************************************
- *int uniform(int lo, int hi)
+ *void fill_zipf_addresses(int *out, int n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It fills Zipf distributed addresses from alias table. High half of random word
+ *             picks the column and low half decides between column and its alias.
+ *Parameters:
+ *int *out O/P: Buffer for addresses.
+ *int n I/P: Number of addresses, at most BULK_SIZE.
+ *This routine does not return anything.
+ *******************************************************************/
+void fill_zipf_addresses(int *out, int n){
+    int i;
+    prng_x4_fill(&bulk_rng, random_words, n);
+    for(i=0;i<n;i++){
+      int column = (int)(((random_words[i]>>32)*(uint64_t)page_space)>>32);
+      uint32_t coin = (uint32_t)random_words[i];
+      out[i] = coin<zipf_threshold[column]?column:zipf_alias[column];
+    }
+}
+
+/*******************************************************************
+ *void fill_phased_addresses(int *out, long long first, int n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It fills addresses drawn uniformly from phase_pages consecutive pages. At every
+ *             phase_length references working set moves to a new random base.
+ *Parameters:
+ *int *out O/P: Buffer for addresses.
+ *long long first I/P: Position of out[0] in address stream, used to find phase boundaries.
+ *int n I/P: Number of addresses, at most BULK_SIZE.
+ *This routine does not return anything.
+ *******************************************************************/
+void fill_phased_addresses(int *out, long long first, int n){
+    int i;
+    static int base_addr;
+    prng_x4_fill(&bulk_rng, random_words, n);
+    for(i=0;i<n;i++){
+      if((first+i)%phase_length==0){
+        base_addr = uniform(0, page_space-phase_pages);
+      }
+      out[i] = base_addr + (int)(((random_words[i]>>32)*(uint64_t)phase_pages)>>32);
+    }
+}
+
+/*******************************************************************
+ *void generate_address_chunk(int *out, long long first, int n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It fills n addresses of selected workload starting at position first of the
+ *             address stream.
+ *Parameters:
+ *int *out O/P: Buffer for addresses.
+ *long long first I/P: Position of out[0] in address stream.
+ *int n I/P: Number of addresses, at most BULK_SIZE.
+ *This routine does not return anything.
+ *******************************************************************/
+void generate_address_chunk(int *out, long long first, int n){
+    if(workload==WORKLOAD_UNIFORM){
+      fill_uniform_addresses(out, n);
+    }else if(workload==WORKLOAD_ZIPF){
+      fill_zipf_addresses(out, n);
+    }else if(workload==WORKLOAD_PHASED){
+      fill_phased_addresses(out, first, n);
+    }else{
+      fill_normal_addresses(out, first, n);
+    }
+}
+
+/*******************************************************************
+ *void generatePageAddresses()
  *Author: Prashant Yadav
  *Date: 10/28/2019
- *Description: It geneates uniformly distributed random numbers between given range.
+ *Description: It populates address array with stream_length addresses of selected workload,
+ *             BULK_SIZE addresses at a time.
  *Parameters:
- *int lo I/P: It is lower bound on given ranges
- *int hi I/P: It is upper bound on given ranges
+ *This routine does not take any argument.
  *This routine does not return anything.
  *******************************************************************/
 void generatePageAddresses(){
-    int part,index;
-    for( part=0; part<10; part++ )
+    int first;
+    for(first=0; first<stream_length; first+=BULK_SIZE)
     {
-      int base_addr = 25 * uniform(0,9);
-      for( index=0; index <100; index ++ )
-      {
-	address[100*part+index] = base_addr + normal();
-      }
+      int n = stream_length-first<BULK_SIZE?stream_length-first:BULK_SIZE;
+      generate_address_chunk(address+first, first, n);
     }
 }
 
@@ -206,17 +616,13 @@ int lru_policy_faults(int working_set){
 	  //and place this location at the start. 
       if(location==NULL && lru_cache.cache_size==working_set){ 
         fault_count++;
+        location = lru_cache.end->prev;   //Reuse least recently used location for new address
         lru_cache.end->prev->prev->next = lru_cache.end;
 	lru_cache.end->prev = lru_cache.end->prev->prev;
-	location = (struct memory_location*)malloc(sizeof(struct memory_location));
 	location->address = address[i];
-	location->next=(struct memory_location*)malloc(sizeof(struct memory_location));
-	location->prev=(struct memory_location*)malloc(sizeof(struct memory_location));
 	lru_cache.cache_size=lru_cache.cache_size-1;
       }else if(location==NULL){
         location = (struct memory_location*)malloc(sizeof(struct memory_location));
-	location->next=(struct memory_location*)malloc(sizeof(struct memory_location));
-	location->prev=(struct memory_location*)malloc(sizeof(struct memory_location));
         location->address = address[i];
       }else{
         location->next->prev = location->prev;
@@ -252,12 +658,12 @@ int fifo_policy_faults(int working_set){
 	  //If location is null place that locationn at the end of cache and update cache size
       location = (struct memory_location*)malloc(sizeof(struct memory_location));
       location->address = address[i];
-      location->next=(struct memory_location*)malloc(sizeof(struct memory_location));
-      location->prev=(struct memory_location*)malloc(sizeof(struct memory_location));
       if(fifo_cache.cache_size==working_set){
         fault_count++;
+        struct memory_location *victim = fifo_cache.start->next;
 	fifo_cache.start->next->next->prev = fifo_cache.start;
 	fifo_cache.start->next = fifo_cache.start->next->next;
+        free(victim);
         fifo_cache.cache_size--;
       }
       location->prev = fifo_cache.end->prev;
@@ -288,11 +694,9 @@ int random_policy_faults(int working_set){
 	  //If location not found create location and place it at appropriate location as per Random eviction policy
       location = (struct memory_location*)malloc(sizeof(struct memory_location));
       location->address = address[i];
-      location->next=(struct memory_location*)malloc(sizeof(struct memory_location));
-      location->prev=(struct memory_location*)malloc(sizeof(struct memory_location));
       if(random_cache.cache_size==working_set){
          fault_count++;
-	 int index = 1+(rand()%random_cache.cache_size);
+	 int index = 1+prng_bounded(&rng, random_cache.cache_size);
 	 struct memory_location * temp = random_cache.start->next;
 	 while(index>1){
            index--;
@@ -300,6 +704,7 @@ int random_policy_faults(int working_set){
 	 }
 	 temp->prev->next = temp->next;
 	 temp->next->prev = temp->prev;
+	 free(temp);
 	 random_cache.cache_size--;
       }
       location->next = random_cache.start->next;
@@ -332,8 +737,6 @@ int clock_policy_faults(int working_set){
 	  //If location not found create memory location and place it appropriate location as per clock eviction policy.
       location = (struct memory_location*)malloc(sizeof(struct memory_location));
       location->address = address[i];
-      location->next=(struct memory_location*)malloc(sizeof(struct memory_location));
-      location->prev=(struct memory_location*)malloc(sizeof(struct memory_location));
       location->use=1;
       if(clock_cache.cache_size==working_set){
         fault_count++;
@@ -356,10 +759,12 @@ int clock_policy_faults(int working_set){
       if(clock==clock_cache.end){
          location->next = clock;
 	 clock->prev = location;
-      }else{
+      }else{   //Location takes place of the evicted one under clock hand
+        struct memory_location *victim = clock;
         location->next = clock->next;
         clock->next->prev = location;
 	clock=location->next;
+	free(victim);
       }
       clock_cache.cache_size++;
     }
@@ -367,104 +772,1990 @@ int clock_policy_faults(int working_set){
 }
 
 /*******************************************************************
- *void simulatePageFaults()
+ *void frame_table_init(struct frame_table *t, int policy, int capacity, int *frames, unsigned char *use, int *slot, int stride)
  *Author: Prashant Yadav
- *Date: 10/28/2019
- *Description: This routine simulates page faults for working set size from 2 to 20.
+ *Date: 10/19/2026
+ *Description: It initializes an empty frame table. Caller provides 3*capacity ints for page
+ *             and LRU links, capacity bytes for use bits and a slot array already set to NO_FRAME.
+ *             Dirty bits are not kept unless caller sets dirty array afterwards.
+ *Parameters:
+ *struct frame_table *t I/P: Frame table to initialize.
+ *int policy I/P: Eviction policy.
+ *int capacity I/P: Number of frames.
+ *int *frames I/P: Storage for page, prev and next arrays.
+ *unsigned char *use I/P: Storage for use bits.
+ *int *slot I/P: Slot of page 0, slot of page p is slot[p*stride]. NULL makes lookups search frames.
+ *int stride I/P: Distance between slots of consecutive pages.
+ *This routine does not return anything.
+ *******************************************************************/
+void frame_table_init(struct frame_table *t, int policy, int capacity, int *frames, unsigned char *use, int *slot, int stride){
+  t->policy = policy;
+  t->capacity = capacity;
+  t->count = 0;
+  t->hand = 0;
+  t->lru_head = NO_FRAME;
+  t->lru_tail = NO_FRAME;
+  t->page = frames;
+  t->prev = frames+capacity;
+  t->next = frames+2*capacity;
+  t->use = use;
+  t->slot = slot;
+  t->stride = stride;
+  t->rng = &rng;
+  t->dirty = NULL;
+  t->frame = NO_FRAME;
+  memset(use, 0, capacity);
+}
+
+/*******************************************************************
+ *int frame_table_reference(struct frame_table *t, int page, int *victim)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It references page in frame table. On a miss page goes to a free frame, or to the
+ *             frame chosen by policy when all frames are in use. Policies behave as the linked
+ *             list versions: LRU evicts least recently used, FIFO oldest, CLOCK first frame
+ *             with clear use bit after the hand and RANDOM a random frame. Frame of page is
+ *             left in t->frame, so caller can set its dirty bit on a write.
+ *Parameters:
+ *struct frame_table *t I/P: Frame table.
+ *int page I/P: Referenced page.
+ *int *victim O/P: Evicted page when FRAME_EVICT is returned.
+ *int O/P: It returns FRAME_HIT, FRAME_FILL or FRAME_EVICT.
+ *******************************************************************/
+int frame_table_reference(struct frame_table *t, int page, int *victim){
+  int *slot = NULL;
+  int frame = NO_FRAME, result;
+  if(t->slot!=NULL){
+    slot = &t->slot[(size_t)page*t->stride];
+    frame = *slot;
+  }else{   //Small table without slot array, search frames
+    for(result=0;result<t->count;result++){
+      if(t->page[result]==page){
+        frame = result;
+        break;
+      }
+    }
+  }
+  if(frame!=NO_FRAME){
+    if(t->policy==POLICY_CLOCK){
+      t->use[frame]=1;
+    }else if(t->policy==POLICY_LRU && frame!=t->lru_head){  //Move frame to head of LRU order
+      t->next[t->prev[frame]] = t->next[frame];
+      if(frame==t->lru_tail){
+        t->lru_tail = t->prev[frame];
+      }else{
+        t->prev[t->next[frame]] = t->prev[frame];
+      }
+      t->prev[frame] = NO_FRAME;
+      t->next[frame] = t->lru_head;
+      t->prev[t->lru_head] = frame;
+      t->lru_head = frame;
+    }
+    t->frame = frame;
+    return FRAME_HIT;
+  }
+  if(t->count<t->capacity){
+    frame = t->count++;
+    result = FRAME_FILL;
+  }else{
+    if(t->policy==POLICY_LRU){
+      frame = t->lru_tail;
+    }else if(t->policy==POLICY_FIFO){
+      frame = t->hand;
+      t->hand = t->hand+1==t->capacity?0:t->hand+1;
+    }else if(t->policy==POLICY_CLOCK){
+      while(t->use[t->hand]){   //Give second chance to frames with use bit set
+        t->use[t->hand]=0;
+        t->hand = t->hand+1==t->capacity?0:t->hand+1;
+      }
+      frame = t->hand;
+      t->hand = t->hand+1==t->capacity?0:t->hand+1;
+    }else{
+      frame = (int)prng_bounded(t->rng, t->capacity);
+    }
+    *victim = t->page[frame];
+    if(slot!=NULL){
+      t->slot[(size_t)*victim*t->stride] = NO_FRAME;
+    }
+    result = FRAME_EVICT;
+  }
+  t->page[frame] = page;
+  if(slot!=NULL){
+    *slot = frame;
+  }
+  if(t->dirty!=NULL){
+    t->victim_dirty = result==FRAME_EVICT && t->dirty[frame];
+    t->dirty[frame] = 0;
+  }
+  t->frame = frame;
+  t->use[frame] = 1;
+  if(t->policy==POLICY_LRU){
+    if(result==FRAME_EVICT && t->count>1){   //Unlink tail before putting it at head
+      t->lru_tail = t->prev[frame];
+      t->next[t->lru_tail] = NO_FRAME;
+    }else if(result==FRAME_EVICT){
+      t->lru_head = NO_FRAME;
+      t->lru_tail = NO_FRAME;
+    }
+    t->prev[frame] = NO_FRAME;
+    t->next[frame] = t->lru_head;
+    if(t->lru_head!=NO_FRAME){
+      t->prev[t->lru_head] = frame;
+    }else{
+      t->lru_tail = frame;
+    }
+    t->lru_head = frame;
+  }
+  return result;
+}
+
+/*******************************************************************
+ *void fused_prepare()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It sets up empty frame tables of all four policies for working set size 2 to 20.
+ *             Slots of one page for all 76 frame tables are next to each other, so each address
+ *             is read once and its lookups share a cache line or two.
  *Parameters:
  *This routine does not take any argument.
  *This routine does not return anything.
  *******************************************************************/
-void simulatePageFaults()
-{
-     generatePageAddresses();
-     int working_set;
-     for(working_set=2;working_set<=20;working_set++){
-        initialize_cache();
-	faults[working_set-2][0]+=lru_policy_faults(working_set);	  //Simulate LRU eviction policy
-	faults[working_set-2][1] += fifo_policy_faults(working_set);  //Simulate FIFO eviction policy 
-	faults[working_set-2][2] += clock_policy_faults(working_set); //Simulate CLOCK eviction policy
-	faults[working_set-2][3] += random_policy_faults(working_set);//Simulate RANDOM eviction policy
-     }
+void fused_prepare(){
+  int i,k,max_page=0;
+  for(i=0;i<stream_length;i++){
+    max_page = address[i]>max_page?address[i]:max_page;
+  }
+  if(max_page+1>fused_slot_pages){   //Grow slot array to cover every page of the stream
+    fused_slot_pages = max_page+1;
+    fused_slots = (int*)realloc(fused_slots, (size_t)fused_slot_pages*INSTANCES*sizeof(int));
+  }
+  if(fused_frames==NULL){
+    fused_frames = (int*)malloc(3*POLICIES*(2+20)*WORKING_SETS/2*sizeof(int));
+    fused_use = (unsigned char*)malloc(POLICIES*(2+20)*WORKING_SETS/2);
+  }
+  for(i=0;i<(max_page+1)*INSTANCES;i++){
+    fused_slots[i] = NO_FRAME;
+  }
+  int *frames = fused_frames;
+  unsigned char *use = fused_use;
+  for(k=0;k<INSTANCES;k++){   //Instance k is policy k%POLICIES with k/POLICIES+2 frames
+    int capacity = k/POLICIES+2;
+    frame_table_init(&fused_tables[k], k%POLICIES, capacity, frames, use, fused_slots+k, INSTANCES);
+    frames += 3*capacity;
+    use += capacity;
+  }
 }
 
 /*******************************************************************
- *void inializeFaultMatrix()
+ *void fused_policy_faults(long long result[WORKING_SETS][POLICIES])
  *Author: Prashant Yadav
- *Date: 10/28/2019
- *Description: This routine initializes fault matrix with 0 before simulation.
+ *Date: 10/19/2026
+ *Description: It simulates all four policies for working set size 2 to 20 in a single pass
+ *             over address stream. Instances of stopped cells are skipped.
+ *Parameters:
+ *long long result[WORKING_SETS][POLICIES] O/P: Faults are added to this matrix.
+ *This routine does not return anything.
+ *******************************************************************/
+void fused_policy_faults(long long result[WORKING_SETS][POLICIES]){
+  int i,k,a,victim,n=0;
+  int counts[INSTANCES];
+  fused_prepare();
+  for(k=0;k<INSTANCES;k++){
+    counts[k] = 0;
+    if(cell_active[k/POLICIES][k%POLICIES]){
+      fused_active[n++] = k;
+    }
+  }
+  for(i=0;i<stream_length;i++){
+    int page = address[i];
+    for(a=0;a<n;a++){
+      k = fused_active[a];
+      counts[k] += frame_table_reference(&fused_tables[k], page, &victim)==FRAME_EVICT;
+    }
+  }
+  for(k=0;k<INSTANCES;k++){
+    result[k/POLICIES][k%POLICIES] += counts[k];
+  }
+}
+
+/*******************************************************************
+ *int frame_table_clean(struct frame_table *t, int batch)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It writes back up to batch dirty frames, starting with frames policy would
+ *             evict first: from LRU tail for LRU, from hand for FIFO, CLOCK and RANDOM.
+ *Parameters:
+ *struct frame_table *t I/P: Frame table with dirty bits.
+ *int batch I/P: Most frames written.
+ *int O/P: It returns number of frames written.
+ *******************************************************************/
+int frame_table_clean(struct frame_table *t, int batch){
+  int i,written=0;
+  int frame = t->policy==POLICY_LRU?t->lru_tail:t->hand;
+  for(i=0;i<t->count && written<batch;i++){
+    if(t->dirty[frame]){
+      t->dirty[frame] = 0;
+      written++;
+    }
+    if(t->policy==POLICY_LRU){
+      frame = t->prev[frame];
+    }else{
+      frame = frame+1==t->count?0:frame+1;
+    }
+  }
+  return written;
+}
+
+/*******************************************************************
+ *void cost_policy_faults()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It simulates all policies and working set sizes in one pass with dirty bits.
+ *             A write sets dirty bit of page's frame and evicting a dirty frame writes it
+ *             back. When cleaner is enabled it writes back a batch of dirty frames of every
+ *             table each cleaner_interval references, off the fault path.
  *Parameters:
  *This routine does not take any argument.
  *This routine does not return anything.
  *******************************************************************/
-void inializeFaultMatrix(){
-  int i;
-  for(i=0;i<19;i++){
-     faults[i][0]=0;
-     faults[i][1]=0;
-     faults[i][2]=0;
-     faults[i][3]=0;
+void cost_policy_faults(){
+  int i,k,victim,first;
+  if(cost_dirty==NULL){
+    cost_dirty = (unsigned char*)malloc(POLICIES*(2+20)*WORKING_SETS/2);
+    cost_writes = (unsigned char*)malloc(stream_length);
+  }
+  for(first=0;first<stream_length;first+=BULK_SIZE){   //Write flags come from their own stream
+    int n = stream_length-first<BULK_SIZE?stream_length-first:BULK_SIZE;
+    prng_x4_fill(&write_rng, random_words, n);
+    for(i=0;i<n;i++){
+      cost_writes[first+i] = (random_words[i]>>32)<write_threshold;
+    }
+  }
+  fused_prepare();
+  unsigned char *dirty = cost_dirty;
+  for(k=0;k<INSTANCES;k++){
+    int capacity = k/POLICIES+2;
+    fused_tables[k].dirty = dirty;
+    fused_tables[k].rng = &cost_rng;
+    memset(dirty, 0, capacity);
+    dirty += capacity;
+  }
+  for(i=0;i<stream_length;i++){
+    int page = address[i];
+    for(k=0;k<INSTANCES;k++){
+      struct frame_table *t = &fused_tables[k];
+      if(frame_table_reference(t, page, &victim)!=FRAME_HIT){
+        cost_misses[k/POLICIES][k%POLICIES]++;
+        cost_dirty_evictions[k/POLICIES][k%POLICIES] += t->victim_dirty;
+      }
+      t->dirty[t->frame] |= cost_writes[i];
+    }
+    if(cleaner_interval>0 && (i+1)%cleaner_interval==0){
+      for(k=0;k<INSTANCES;k++){
+        cost_cleaner_writes[k/POLICIES][k%POLICIES] += frame_table_clean(&fused_tables[k], cleaner_batch);
+      }
+    }
   }
 }
 
 /*******************************************************************
- *void printFaultMatrix()
+ *void printCostModel()
  *Author: Prashant Yadav
- *Date: 10/28/2019
- *Description: It prints fault matrix.
+ *Date: 10/19/2026
+ *Description: It prints modeled time per reference, dirty evictions and cleaner writes for
+ *             every policy and working set size. Hits cost hit_cost, misses fault_cost and
+ *             dirty evictions writeback_cost more. Cleaner writes are not on fault path.
  *Parameters:
  *This routine does not take any argument.
  *This routine does not return anything.
  *******************************************************************/
-void printFaultMatrix(){
-  int i;
-  printf("\n------------------------------------------------------------\n");
-  printf("Eviction policy ->              LRU\tFIFO\tCLOCK\tRANDOM\n");
-  for(i=0;i<19;i++){
-    printf("Faults for working set %d is - \t%d\t%d\t%d\t%d\n",i+2,faults[i][0],faults[i][1],faults[i][2],faults[i][3]);
+void printCostModel(){
+  int i,k;
+  printf("Cost model: write ratio %.2f, hit %lld ns, fault %lld ns, dirty eviction %lld ns",write_ratio,
+         hit_cost,fault_cost,writeback_cost);
+  if(cleaner_interval>0){
+    printf(", cleaner %d frames every %d references",cleaner_batch,cleaner_interval);
+  }
+  printf("\nModeled ns per reference ->     LRU\tFIFO\tCLOCK\tRANDOM\n");
+  for(i=0;i<WORKING_SETS;i++){
+    printf("Time for working set %d is - \t",i+2);
+    for(k=0;k<POLICIES;k++){
+      long long hits = (long long)experiments*stream_length-cost_misses[i][k];
+      double total = (double)hits*hit_cost+(double)cost_misses[i][k]*fault_cost+
+                     (double)cost_dirty_evictions[i][k]*writeback_cost;
+      printf("%.0f%c",total/experiments/stream_length,k+1<POLICIES?'\t':'\n');
+    }
+  }
+  printf("Dirty evictions, cleaner writes -> LRU\tFIFO\tCLOCK\tRANDOM\n");
+  for(i=0;i<WORKING_SETS;i++){
+    printf("Writes for working set %d is - \t",i+2);
+    for(k=0;k<POLICIES;k++){
+      printf("%lld,%lld%c",cost_dirty_evictions[i][k]/experiments,cost_cleaner_writes[i][k]/experiments,
+             k+1<POLICIES?'\t':'\n');
+    }
   }
-  printf("--------------------------------------------------------------\n");
 }
 
 /*******************************************************************
- *void normalizeFaultMatrix()
+ *int frame_table_prefetch(struct frame_table *t, const int *pages, int n, unsigned char *prefetched, long long *wasted)
  *Author: Prashant Yadav
- *Date: 10/28/2019
- *Description: This routine normalizes fault matrix for given number of experiments.
+ *Date: 10/19/2026
+ *Description: It loads a batch of prefetched pages after a demand reference. Resident pages
+ *             are skipped and the rest are loaded in one pass: free frames first, then frames
+ *             policy would evict, never frame of demanded page or a frame of this batch. So at
+ *             most capacity-1 pages are loaded. LRU links batch right behind demanded page,
+ *             CLOCK leaves use bits of batch clear as pages are not referenced yet. Flag of
+ *             every loaded frame is set in prefetched, an evicted frame whose flag is still set
+ *             was never used.
+ *Parameters:
+ *struct frame_table *t I/P: Frame table with slot array, t->frame is demanded page.
+ *const int *pages I/P: Pages to prefetch.
+ *int n I/P: Number of pages.
+ *unsigned char *prefetched I/P: Prefetched and not yet used flag of each frame.
+ *long long *wasted O/P: Evicted pages which were prefetched and never used are added.
+ *int O/P: It returns number of pages loaded.
+ *******************************************************************/
+int frame_table_prefetch(struct frame_table *t, const int *pages, int n, unsigned char *prefetched, long long *wasted){
+  int batch[MAX_READAHEAD];
+  int i,j,loaded=0;
+  int demand = t->frame, after = t->frame;   //LRU inserts after this frame
+  for(i=0;i<n && loaded<t->capacity-1;i++){
+    int *slot = &t->slot[(size_t)pages[i]*t->stride];
+    int frame;
+    if(*slot!=NO_FRAME){
+      continue;
+    }
+    if(t->count<t->capacity){
+      frame = t->count++;
+    }else{
+      if(t->policy==POLICY_LRU){
+        frame = t->lru_tail;
+        t->lru_tail = t->prev[frame];
+        t->next[t->lru_tail] = NO_FRAME;
+      }else if(t->policy==POLICY_FIFO){
+        if(t->hand==demand){
+          t->hand = t->hand+1==t->capacity?0:t->hand+1;
+        }
+        frame = t->hand;
+        t->hand = t->hand+1==t->capacity?0:t->hand+1;
+      }else if(t->policy==POLICY_CLOCK){
+        while(t->use[t->hand] || t->hand==demand){
+          t->use[t->hand]=0;
+          t->hand = t->hand+1==t->capacity?0:t->hand+1;
+        }
+        frame = t->hand;
+        t->hand = t->hand+1==t->capacity?0:t->hand+1;
+      }else{
+        do{   //Draw again when frame is demanded page or was loaded by this batch
+          frame = (int)prng_bounded(t->rng, t->capacity);
+          for(j=0;j<loaded && batch[j]!=frame;j++);
+        }while(frame==demand || j<loaded);
+      }
+      t->slot[(size_t)t->page[frame]*t->stride] = NO_FRAME;
+      *wasted += prefetched[frame];
+    }
+    t->page[frame] = pages[i];
+    *slot = frame;
+    prefetched[frame] = 1;
+    t->use[frame] = 0;
+    if(t->policy==POLICY_LRU){
+      t->prev[frame] = after;
+      t->next[frame] = t->next[after];
+      if(t->next[after]!=NO_FRAME){
+        t->prev[t->next[after]] = frame;
+      }else{
+        t->lru_tail = frame;
+      }
+      t->next[after] = frame;
+      after = frame;
+    }
+    batch[loaded++] = frame;
+  }
+  return loaded;
+}
+
+/*******************************************************************
+ *int prefetch_pages(struct prefetch_state *s, int page, int result, int prefetch_hit, int max_page, int *pages)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It decides pages to prefetch after a demand reference, by prefetch_mode.
+ *             Fixed readahead takes next readahead pages on every miss. Adaptive readahead
+ *             works as Linux ondemand readahead: a miss right after previous page opens a
+ *             window of readahead pages, first page of window is a marker and using it opens
+ *             next window right after, each window twice as large up to readahead_max. Other
+ *             misses are random reads and reset window. Stride detection looks for same step
+ *             between three references in a row and then prefetches readahead pages along it
+ *             on a miss or on use of a prefetched page. Pages outside 0..max_page are dropped.
+ *Parameters:
+ *struct prefetch_state *s I/P: Prefetcher state of one frame table.
+ *int page I/P: Demanded page.
+ *int result I/P: FRAME_HIT, FRAME_FILL or FRAME_EVICT of demand reference.
+ *int prefetch_hit I/P: 1 when demanded page was prefetched and not used before.
+ *int max_page I/P: Largest page of address stream.
+ *int *pages O/P: Pages to prefetch.
+ *int O/P: It returns number of pages.
+ *******************************************************************/
+int prefetch_pages(struct prefetch_state *s, int page, int result, int prefetch_hit, int max_page, int *pages){
+  int i,n=0,first=0,step=1,count=0;
+  if(prefetch_mode==PREFETCH_FIXED){
+    if(result!=FRAME_HIT){
+      first = page+1;
+      count = readahead;
+    }
+  }else if(prefetch_mode==PREFETCH_ADAPTIVE){
+    if(result!=FRAME_HIT){
+      if(page==s->last+1){   //Sequential miss, start or grow window
+        s->size = s->size==0?readahead:(2*s->size<readahead_max?2*s->size:readahead_max);
+        s->start = page+1;
+        s->marker = s->start;
+        first = s->start;
+        count = s->size;
+      }else{
+        s->size = 0;
+      }
+    }else if(prefetch_hit && page==s->marker && s->size>0){   //Reader reached window, read next one
+      s->start += s->size;
+      s->size = 2*s->size<readahead_max?2*s->size:readahead_max;
+      s->marker = s->start;
+      first = s->start;
+      count = s->size;
+    }
+  }else{
+    int stride = page-s->last;
+    s->confidence = stride!=0 && stride==s->stride?s->confidence+1:0;
+    s->stride = stride;
+    if(s->confidence>=1 && (result!=FRAME_HIT || prefetch_hit)){
+      first = page+stride;
+      step = stride;
+      count = readahead;
+    }
+  }
+  s->last = page;
+  for(i=0;i<count;i++){
+    int p = first+i*step;
+    if(p<0 || p>max_page){
+      break;
+    }
+    pages[n++] = p;
+  }
+  return n;
+}
+
+/*******************************************************************
+ *void prefetch_policy_faults()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It simulates all policies and working set sizes twice on current stream, on
+ *             demand only and with prefetcher in front, and adds up misses of demand
+ *             references, including first loads, prefetch hits, prefetched pages and pages
+ *             evicted before use. Prefetched pages of a reference are loaded as one batch.
  *Parameters:
  *This routine does not take any argument.
  *This routine does not return anything.
  *******************************************************************/
-void normalizeFaultMatrix(){
-  int i;
-  for(i=0;i<19;i++){
-    faults[i][0]/=experiments;
-    faults[i][1]/=experiments;
-    faults[i][2]/=experiments;
-    faults[i][3]/=experiments;
+void prefetch_policy_faults(){
+  static struct prefetch_state state[INSTANCES];
+  unsigned char *flags[INSTANCES];
+  int pages[MAX_READAHEAD];
+  int i,k,victim,pass,max_page=0;
+  for(i=0;i<stream_length;i++){
+    max_page = address[i]>max_page?address[i]:max_page;
+  }
+  if(prefetch_flags==NULL){
+    prefetch_flags = (unsigned char*)malloc(POLICIES*(2+20)*WORKING_SETS/2);
+  }
+  for(pass=0;pass<2;pass++){   //Demand only, then with prefetcher
+    unsigned char *next = prefetch_flags;
+    fused_prepare();
+    for(k=0;k<INSTANCES;k++){
+      int capacity = k/POLICIES+2;
+      fused_tables[k].rng = &prefetch_rng;
+      flags[k] = next;
+      memset(next, 0, capacity);
+      next += capacity;
+      state[k].last = -2;
+      state[k].stride = state[k].confidence = state[k].start = state[k].size = state[k].marker = 0;
+    }
+    for(i=0;i<stream_length;i++){
+      int page = address[i];
+      for(k=0;k<INSTANCES;k++){
+        struct frame_table *t = &fused_tables[k];
+        int result = frame_table_reference(t, page, &victim);
+        if(pass==0){
+          prefetch_base[k/POLICIES][k%POLICIES] += result!=FRAME_HIT;
+          continue;
+        }
+        //Flag of frame is still that of its old page after an eviction
+        int flagged = flags[k][t->frame];
+        int hit = result==FRAME_HIT && flagged;
+        prefetch_wasted[k/POLICIES][k%POLICIES] += result==FRAME_EVICT && flagged;
+        flags[k][t->frame] = 0;
+        prefetch_misses[k/POLICIES][k%POLICIES] += result!=FRAME_HIT;
+        prefetch_hits[k/POLICIES][k%POLICIES] += hit;
+        int n = prefetch_pages(&state[k], page, result, hit, max_page, pages);
+        if(n>0){
+          prefetch_loaded[k/POLICIES][k%POLICIES] += frame_table_prefetch(t, pages, n, flags[k],
+                                                                          &prefetch_wasted[k/POLICIES][k%POLICIES]);
+        }
+      }
+    }
   }
 }
 
 /*******************************************************************
- *void main()
+ *void printPrefetch()
  *Author: Prashant Yadav
- *Date: 10/28/2019
- *Description: This is the driver method which simulates fault calculation process for 1000 experiments.
+ *Date: 10/19/2026
+ *Description: It prints demand misses with prefetcher next to misses on demand only, and
+ *             prefetch hits and wasted prefetches, per experiment for every policy and working
+ *             set size, then share of misses prefetcher removed and share of prefetched pages
+ *             used.
  *Parameters:
  *This routine does not take any argument.
  *This routine does not return anything.
  *******************************************************************/
-void main()
-{
-    int experiment;
-    inializeFaultMatrix();  //Initialize fault matrix before starting simulations
-    for(experiment=0;experiment<experiments;experiment++)
-    {
-      printf("Starting Simulation for %d\n",experiment+1);
-      simulatePageFaults();	
+void printPrefetch(){
+  const char *names[] = {"none","fixed","adaptive","stride"};
+  long long base=0, misses=0, hits=0, loaded=0;
+  int i,k;
+  printf("Prefetch %s, readahead %d",names[prefetch_mode],readahead);
+  if(prefetch_mode==PREFETCH_ADAPTIVE){
+    printf(" up to %d",readahead_max);
+  }
+  printf("\nDemand misses, misses without prefetch -> LRU\tFIFO\tCLOCK\tRANDOM\n");
+  for(i=0;i<WORKING_SETS;i++){
+    printf("Misses for working set %d is - \t",i+2);
+    for(k=0;k<POLICIES;k++){
+      printf("%lld,%lld%c",prefetch_misses[i][k]/experiments,prefetch_base[i][k]/experiments,
+             k+1<POLICIES?'\t':'\n');
+      base += prefetch_base[i][k];
+      misses += prefetch_misses[i][k];
+      hits += prefetch_hits[i][k];
+      loaded += prefetch_loaded[i][k];
     }
-    normalizeFaultMatrix();	//Normalize fault matrix
-    printFaultMatrix();	//Print fault matrix.
+  }
+  printf("Prefetch hits, wasted prefetches -> LRU\tFIFO\tCLOCK\tRANDOM\n");
+  for(i=0;i<WORKING_SETS;i++){
+    printf("Prefetch for working set %d is - \t",i+2);
+    for(k=0;k<POLICIES;k++){
+      printf("%lld,%lld%c",prefetch_hits[i][k]/experiments,prefetch_wasted[i][k]/experiments,
+             k+1<POLICIES?'\t':'\n');
+    }
+  }
+  printf("Prefetch removed %.2f%% of misses, %.2f%% of prefetched pages were used\n",
+         base>0?100.0*(base-misses)/base:0,loaded>0?100.0*hits/loaded:0);
+}
+
+/*******************************************************************
+ *int parse_policy(const char *name)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It converts policy name to policy number, exits on unknown name.
+ *Parameters:
+ *const char *name I/P: lru, fifo, clock or random.
+ *int O/P: It returns policy number.
+ *******************************************************************/
+int parse_policy(const char *name){
+  const char *names[POLICIES] = {"lru","fifo","clock","random"};
+  int k;
+  for(k=0;k<POLICIES;k++){
+    if(strcmp(name,names[k])==0){
+      return k;
+    }
+  }
+  printf("Unknown policy %s\n",name);
+  exit(1);
+}
+
+/*******************************************************************
+ *int tlb_lookup(int page)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It looks up page in set associative TLB and fills an entry on a miss. Tags of a
+ *             set are next to each other and all ways are compared without branches. For LRU
+ *             a set is kept in most recently used order, other policies keep ways in place.
+ *Parameters:
+ *int page I/P: Referenced page.
+ *int O/P: It returns 1 on TLB hit and 0 on miss.
+ *******************************************************************/
+int tlb_lookup(int page){
+  uint32_t tag = (uint32_t)page+1;
+  int set = page%tlb_sets;
+  uint32_t *row = tlb_tags+(size_t)set*tlb_ways;
+  int w, way=-1, empty=-1;
+  for(w=tlb_ways-1;w>=0;w--){   //Lowest matching and lowest empty way
+    way = row[w]==tag?w:way;
+    empty = row[w]==0?w:empty;
+  }
+  if(way>=0){
+    if(tlb_policy==POLICY_LRU && way>0){
+      memmove(row+1, row, way*sizeof(uint32_t));
+      row[0] = tag;
+    }else if(tlb_policy==POLICY_CLOCK){
+      tlb_use[set] |= 1ULL<<way;
+    }
+    return 1;
+  }
+  if(tlb_policy==POLICY_LRU){   //Last way is least recently used or empty
+    memmove(row+1, row, (tlb_ways-1)*sizeof(uint32_t));
+    row[0] = tag;
+    return 0;
+  }
+  if(empty>=0){
+    way = empty;
+  }else if(tlb_policy==POLICY_FIFO){
+    way = tlb_hand[set];
+    tlb_hand[set] = way+1==tlb_ways?0:way+1;
+  }else if(tlb_policy==POLICY_CLOCK){
+    while(tlb_use[set]>>tlb_hand[set]&1){   //Give second chance to ways with use bit set
+      tlb_use[set] &= ~(1ULL<<tlb_hand[set]);
+      tlb_hand[set] = tlb_hand[set]+1==tlb_ways?0:tlb_hand[set]+1;
+    }
+    way = tlb_hand[set];
+    tlb_hand[set] = way+1==tlb_ways?0:way+1;
+  }else{
+    way = (int)prng_bounded(&tlb_rng, tlb_ways);
+  }
+  row[way] = tag;
+  if(tlb_policy==POLICY_CLOCK){
+    tlb_use[set] |= 1ULL<<way;
+  }
+  return 0;
 }
 
+/*******************************************************************
+ *void tlb_invalidate(int page)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It drops TLB entry of page, if any. It is called when page leaves page frames.
+ *Parameters:
+ *int page I/P: Evicted page.
+ *This routine does not return anything.
+ *******************************************************************/
+void tlb_invalidate(int page){
+  uint32_t tag = (uint32_t)page+1;
+  int set = page%tlb_sets;
+  uint32_t *row = tlb_tags+(size_t)set*tlb_ways;
+  int w;
+  for(w=0;w<tlb_ways && row[w]!=tag;w++);
+  if(w==tlb_ways){
+    return;
+  }
+  if(tlb_policy==POLICY_LRU){   //Keep empty ways at end of recency order
+    memmove(row+w, row+w+1, (tlb_ways-1-w)*sizeof(uint32_t));
+    row[tlb_ways-1] = 0;
+  }else{
+    row[w] = 0;
+    tlb_use[set] &= ~(1ULL<<w);
+  }
+}
 
+/*******************************************************************
+ *void hierarchy_faults()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It runs address stream through TLB and page frames. Only TLB misses reach page
+ *             frames, as a page table walk would, and an evicted page is dropped from TLB so
+ *             TLB never maps a page which is not resident.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void hierarchy_faults(){
+  int i,victim,max_page=0;
+  struct timespec t0,t1;
+  for(i=0;i<stream_length;i++){
+    max_page = address[i]>max_page?address[i]:max_page;
+  }
+  if(max_page+1>hierarchy_pages){
+    hierarchy_pages = max_page+1;
+    hierarchy_slot = (int*)realloc(hierarchy_slot, hierarchy_pages*sizeof(int));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(i=0;i<=max_page;i++){
+    hierarchy_slot[i] = NO_FRAME;
+  }
+  memset(tlb_tags, 0, (size_t)tlb_entries*sizeof(uint32_t));
+  memset(tlb_hand, 0, tlb_sets);
+  memset(tlb_use, 0, tlb_sets*sizeof(uint64_t));
+  frame_table_init(&hierarchy_table, page_policy, page_frames, hierarchy_store, hierarchy_use, hierarchy_slot, 1);
+  hierarchy_table.rng = &page_rng;
+  for(i=0;i<stream_length;i++){
+    int page = address[i];
+    if(tlb_lookup(page)){
+      tlb_hits++;
+      continue;
+    }
+    int result = frame_table_reference(&hierarchy_table, page, &victim);
+    if(result==FRAME_HIT){
+      page_hits++;
+    }else{
+      page_misses++;
+      if(result==FRAME_EVICT){
+        tlb_invalidate(victim);
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  hierarchy_seconds += (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)/1e9;
+}
+
+/*******************************************************************
+ *void printHierarchy()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints hit rate of TLB, hit rate of page frames for TLB misses and average
+ *             memory access time. Every reference pays TLB and memory access, a TLB miss a
+ *             page table walk and a page miss a fault.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void printHierarchy(){
+  const char *names[POLICIES] = {"LRU","FIFO","CLOCK","RANDOM"};
+  long long references = tlb_hits+page_hits+page_misses;
+  double amat = tlb_cost+hit_cost+((double)(page_hits+page_misses)*walk_cost+(double)page_misses*fault_cost)/references;
+  printf("TLB %d entries %d ways %s, page frames %d %s\n",tlb_entries,tlb_ways,names[tlb_policy],
+         page_frames,names[page_policy]);
+  printf("TLB hit rate %.4f, page frame hit rate %.4f of TLB misses, %.4f of all references\n",
+         (double)tlb_hits/references,page_hits+page_misses>0?(double)page_hits/(page_hits+page_misses):0,
+         (double)(tlb_hits+page_hits)/references);
+  printf("Average memory access time %.1f ns\n",amat);
+  printf("Hierarchy time %.3f s, %.1f M references/s\n",hierarchy_seconds,
+         hierarchy_seconds>0?references/hierarchy_seconds/1e6:0);
+}
+
+/*******************************************************************
+ *void nested_policy_faults(long long result[WORKING_SETS][POLICIES])
+ *Author: Prashant Yadav
+ *Date: 10/28/2019
+ *Description: It simulates each policy for each working set size with linked list caches,
+ *             passing over address stream once for every policy and size. Stopped cells are
+ *             skipped.
+ *Parameters:
+ *long long result[WORKING_SETS][POLICIES] O/P: Faults are added to this matrix.
+ *This routine does not return anything.
+ *******************************************************************/
+void nested_policy_faults(long long result[WORKING_SETS][POLICIES]){
+     int working_set;
+     for(working_set=2;working_set<=20;working_set++){
+        unsigned char *active = cell_active[working_set-2];
+        initialize_cache();
+	if(active[0]) result[working_set-2][0]+=lru_policy_faults(working_set);	  //Simulate LRU eviction policy
+	if(active[1]) result[working_set-2][1] += fifo_policy_faults(working_set);  //Simulate FIFO eviction policy 
+	if(active[2]) result[working_set-2][2] += clock_policy_faults(working_set); //Simulate CLOCK eviction policy
+	if(active[3]) result[working_set-2][3] += random_policy_faults(working_set);//Simulate RANDOM eviction policy
+     }
+}
+
+/*******************************************************************
+ *int ws_prepare()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It grows per page arrays of working set policies to cover every page of address
+ *             stream and marks all pages as never used.
+ *Parameters:
+ *This routine does not take any argument.
+ *int O/P: It returns number of pages covered.
+ *******************************************************************/
+int ws_prepare(){
+  int i,max_page=0;
+  for(i=0;i<stream_length;i++){
+    max_page = address[i]>max_page?address[i]:max_page;
+  }
+  if(max_page+1>ws_pages){
+    ws_pages = max_page+1;
+    ws_last_use = (int*)realloc(ws_last_use, ws_pages*sizeof(int));
+    wsclock_slot = (int*)realloc(wsclock_slot, ws_pages*sizeof(int));
+    wsclock_page = (int*)realloc(wsclock_page, ws_pages*sizeof(int));
+    wsclock_time = (int*)realloc(wsclock_time, ws_pages*sizeof(int));
+    wsclock_ref = (unsigned char*)realloc(wsclock_ref, ws_pages);
+  }
+  for(i=0;i<=max_page;i++){
+    ws_last_use[i] = NO_FRAME;
+  }
+  return max_page+1;
+}
+
+/*******************************************************************
+ *void working_set_faults()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It simulates WS(tau) for all windows in one pass. Page is resident when it was
+ *             used in last tau references, so it faults when its last use is older than tau.
+ *             Last use times do not depend on tau, and resident set of each window only
+ *             loses page referenced tau ticks ago if it was not used since.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void working_set_faults(){
+  int t,w;
+  int size[WORKING_SETS];
+  long long resident[WORKING_SETS];
+  ws_prepare();
+  for(w=0;w<WORKING_SETS;w++){
+    size[w] = 0;
+    resident[w] = 0;
+  }
+  for(t=0;t<stream_length;t++){
+    int page = address[t], prev = ws_last_use[page];
+    for(w=0;w<WORKING_SETS;w++){
+      int tau = ws_step*(w+1);
+      if(prev==NO_FRAME || prev<t-tau){
+        ws_faults[w][0]++;
+        size[w]++;
+      }
+      if(t>=tau && address[t-tau]!=page && ws_last_use[address[t-tau]]==t-tau){   //Leaves window
+        size[w]--;
+      }
+      resident[w] += size[w];
+    }
+    ws_last_use[page] = t;
+  }
+  for(w=0;w<WORKING_SETS;w++){
+    ws_resident[w][0] += (double)resident[w]/stream_length;
+  }
+}
+
+/*******************************************************************
+ *void wsclock_faults(int w)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It simulates WSClock with window tau of row w. A reference sets use bit of its
+ *             frame. On a fault hand clears set use bits and stamps frame with current time,
+ *             and replaces first frame older than tau. If a whole turn finds no old frame
+ *             resident set grows by one frame.
+ *Parameters:
+ *int w I/P: Row of window, tau is ws_step*(w+1).
+ *This routine does not return anything.
+ *******************************************************************/
+void wsclock_faults(int w){
+  int t,i,count=0,hand=0,tau=ws_step*(w+1);
+  long long resident=0;
+  int pages = ws_prepare();
+  for(i=0;i<pages;i++){
+    wsclock_slot[i] = NO_FRAME;
+  }
+  for(t=0;t<stream_length;t++){
+    int page = address[t], frame = wsclock_slot[page];
+    if(frame!=NO_FRAME){
+      wsclock_ref[frame] = 1;
+    }else{
+      ws_faults[w][1]++;
+      frame = NO_FRAME;
+      for(i=0;i<count;i++){
+        int f = hand;
+        hand = hand+1==count?0:hand+1;
+        if(wsclock_ref[f]){
+          wsclock_ref[f] = 0;
+          wsclock_time[f] = t;
+        }else if(t-wsclock_time[f]>tau){
+          frame = f;
+          wsclock_slot[wsclock_page[f]] = NO_FRAME;
+          break;
+        }
+      }
+      if(frame==NO_FRAME){   //No page outside window, grow resident set
+        frame = count++;
+      }
+      wsclock_page[frame] = page;
+      wsclock_time[frame] = t;
+      wsclock_ref[frame] = 1;
+      wsclock_slot[page] = frame;
+    }
+    resident += count;
+  }
+  ws_resident[w][1] += (double)resident/stream_length;
+}
+
+/*******************************************************************
+ *void printWorkingSetPolicies()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints average faults, fault rate and average resident pages of WS and
+ *             WSClock for every window. Faults include first loads of pages.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void printWorkingSetPolicies(){
+  int w;
+  printf("Window policies (faults include first loads) ->  WS faults\trate\tresident\tWSClock faults\trate\tresident\n");
+  for(w=0;w<WORKING_SETS;w++){
+    printf("Faults for window %d is - \t%lld\t%.4f\t%.2f\t%lld\t%.4f\t%.2f\n",ws_step*(w+1),
+           ws_faults[w][0]/experiments,(double)ws_faults[w][0]/experiments/stream_length,ws_resident[w][0]/experiments,
+           ws_faults[w][1]/experiments,(double)ws_faults[w][1]/experiments/stream_length,ws_resident[w][1]/experiments);
+  }
+}
+
+/*******************************************************************
+ *void *local_process_faults(void *arg)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It is a worker thread of local replacement. Thread k simulates processes k,
+ *             k+threads, ... in their own fixed share of frames for every policy. Processes
+ *             do not share any state, so their interleaving does not change results.
+ *Parameters:
+ *void *arg I/P: Thread index cast to pointer.
+ *void * O/P: It returns NULL.
+ *******************************************************************/
+void *local_process_faults(void *arg){
+  long k = (long)arg;
+  int p,i,policy,victim;
+  for(p=(int)k;p<processes;p+=shared_threads){
+    struct process_state *ps = &process_states[p];
+    for(policy=0;policy<POLICIES;policy++){
+      for(i=0;i<ps->pages;i++){
+        ps->slot[i] = NO_FRAME;
+      }
+      frame_table_init(&ps->table, policy, ps->frames, ps->frame_store, ps->use, ps->slot, 1);
+      ps->table.rng = &ps->rng;
+      for(i=0;i<stream_length;i++){
+        ps->local_faults[policy] += frame_table_reference(&ps->table, ps->address[i], &victim)!=FRAME_HIT;
+      }
+    }
+  }
+  return NULL;
+}
+
+/*******************************************************************
+ *void global_process_faults(int policy)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It simulates global replacement for one policy. Processes run round robin for
+ *             quantum references each and page of any process may be evicted. Page p of
+ *             process q is page_offset[q]+p of the shared frame table. Frames held by each
+ *             process are integrated over time to give its average share.
+ *Parameters:
+ *int policy I/P: Eviction policy.
+ *This routine does not return anything.
+ *******************************************************************/
+void global_process_faults(int policy){
+  int p,i,victim,running;
+  long long t=0;
+  for(i=0;i<shared_pages;i++){
+    shared_slot[i] = NO_FRAME;
+  }
+  frame_table_init(&shared_table, policy, shared_frames, shared_frame_store, shared_use, shared_slot, 1);
+  shared_table.rng = &shared_rng;
+  for(p=0;p<processes;p++){
+    process_states[p].position = 0;
+    process_states[p].held = 0;
+    process_states[p].last_change = 0;
+  }
+  do{
+    running = 0;
+    for(p=0;p<processes;p++){
+      struct process_state *ps = &process_states[p];
+      int end = ps->position+shared_quantum<stream_length?ps->position+shared_quantum:stream_length;
+      for(;ps->position<end;ps->position++,t++){
+        int result = frame_table_reference(&shared_table, page_offset[p]+ps->address[ps->position], &victim);
+        if(result==FRAME_HIT){
+          continue;
+        }
+        ps->global_faults[policy]++;
+        ps->held_time[policy] += ps->held*(t-ps->last_change);
+        ps->last_change = t;
+        ps->held++;
+        if(result==FRAME_EVICT){
+          struct process_state *owner = &process_states[page_owner[victim]];
+          owner->held_time[policy] += owner->held*(t-owner->last_change);
+          owner->last_change = t;
+          owner->held--;
+        }
+      }
+      running += ps->position<stream_length;
+    }
+  }while(running);
+  for(p=0;p<processes;p++){
+    struct process_state *ps = &process_states[p];
+    ps->held_time[policy] += ps->held*(t-ps->last_change);
+    ps->resident[policy] += (double)ps->held_time[policy]/t;
+    ps->held_time[policy] = 0;
+  }
+}
+
+/*******************************************************************
+ *double jain_index(int policy, int global)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It computes Jain fairness index (sum x)^2/(n*sum x^2) of per process faults.
+ *             It is 1 when all processes fault equally and 1/n when one takes all faults.
+ *Parameters:
+ *int policy I/P: Eviction policy.
+ *int global I/P: 1 for global replacement faults, 0 for local.
+ *double O/P: It returns fairness index.
+ *******************************************************************/
+double jain_index(int policy, int global){
+  int p;
+  double sum=0, sum_sq=0;
+  for(p=0;p<processes;p++){
+    double x = global?process_states[p].global_faults[policy]:process_states[p].local_faults[policy];
+    sum += x;
+    sum_sq += x*x;
+  }
+  return sum_sq>0?sum*sum/(processes*sum_sq):1.0;
+}
+
+/*******************************************************************
+ *void simulate_shared_frames()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It simulates processes sharing a pool of frames. Every experiment draws a new
+ *             address stream for each process, runs local replacement on shared_threads
+ *             threads and then global replacement for every policy.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void simulate_shared_frames(){
+  int experiment,p,i;
+  pthread_t workers[MAX_PROCESSES];
+  process_states = (struct process_state*)aligned_alloc(64, processes*sizeof(struct process_state));
+  memset(process_states, 0, processes*sizeof(struct process_state));
+  page_offset = (int*)malloc(processes*sizeof(int));
+  for(p=0;p<processes;p++){
+    struct process_state *ps = &process_states[p];
+    ps->address = (int*)malloc(stream_length*sizeof(int));
+    ps->frames = shared_frames/processes+(p<shared_frames%processes);
+    ps->frame_store = (int*)malloc(3*ps->frames*sizeof(int));
+    ps->use = (unsigned char*)malloc(ps->frames);
+    prng_stream(&ps->rng, seed+3, p);
+  }
+  shared_frame_store = (int*)malloc(3*shared_frames*sizeof(int));
+  shared_use = (unsigned char*)malloc(shared_frames);
+  prng_seed(&shared_rng, seed+9);
+  for(experiment=0;experiment<experiments;experiment++){
+    if(!bench_mode){
+      printf("Starting Simulation for %d\n",experiment+1);
+    }
+    shared_pages = 0;
+    for(p=0;p<processes;p++){   //Streams come from one generator, so they are drawn in order
+      struct process_state *ps = &process_states[p];
+      generatePageAddresses();
+      memcpy(ps->address, address, stream_length*sizeof(int));
+      ps->pages = 0;
+      for(i=0;i<stream_length;i++){
+        ps->pages = address[i]>=ps->pages?address[i]+1:ps->pages;
+      }
+      ps->slot = (int*)realloc(ps->slot, ps->pages*sizeof(int));
+      page_offset[p] = shared_pages;
+      shared_pages += ps->pages;
+    }
+    shared_slot = (int*)realloc(shared_slot, shared_pages*sizeof(int));
+    page_owner = (int*)realloc(page_owner, shared_pages*sizeof(int));
+    for(p=0;p<processes;p++){
+      for(i=0;i<process_states[p].pages;i++){
+        page_owner[page_offset[p]+i] = p;
+      }
+    }
+    for(i=0;i<shared_threads;i++){
+      pthread_create(&workers[i], NULL, local_process_faults, (void*)(long)i);
+    }
+    for(i=0;i<shared_threads;i++){
+      pthread_join(workers[i], NULL);
+    }
+    for(i=0;i<POLICIES;i++){
+      global_process_faults(i);
+      shared_jain[i][0] += jain_index(i, 0);
+      shared_jain[i][1] += jain_index(i, 1);
+    }
+  }
+}
+
+/*******************************************************************
+ *void printSharedFrames()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints average faults of every process under local and global replacement,
+ *             frames each process held under global replacement and fairness of each policy.
+ *             Faults include first loads of pages.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void printSharedFrames(){
+  int p,k;
+  const char *names[POLICIES] = {"LRU","FIFO","CLOCK","RANDOM"};
+  printf("\n%d processes, %d shared frames, quantum %d, %d threads\n",processes,shared_frames,shared_quantum,shared_threads);
+  for(k=0;k<POLICIES;k++){
+    long long local_total=0, global_total=0;
+    printf("%s (faults include first loads) ->  local faults\tglobal faults\tglobal frames\n",names[k]);
+    for(p=0;p<processes;p++){
+      struct process_state *ps = &process_states[p];
+      printf("Faults for process %d is - \t%lld\t%lld\t%.2f\n",p,ps->local_faults[k]/experiments,
+             ps->global_faults[k]/experiments,ps->resident[k]/experiments);
+      local_total += ps->local_faults[k];
+      global_total += ps->global_faults[k];
+    }
+    printf("Total faults local %lld, global %lld, Jain fairness local %.4f, global %.4f\n",
+           local_total/experiments,global_total/experiments,shared_jain[k][0]/experiments,shared_jain[k][1]/experiments);
+  }
+}
+
+/*******************************************************************
+ *void mrc_init(int frames)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It allocates sampled miss ratio curve estimator for caches of up to frames
+ *             frames. Each sampled page between two uses of a page stands for 1/rate pages,
+ *             so LRU stack needs only about rate*frames entries and miniature caches scale
+ *             frame counts by rate.
+ *Parameters:
+ *int frames I/P: Largest frame count of miss ratio curve.
+ *This routine does not return anything.
+ *******************************************************************/
+void mrc_init(int frames){
+  int p;
+  mrc_frames = frames;
+  mrc_threshold = (uint32_t)(mrc_rate*(1<<MRC_HASH_BITS));
+  mrc_rate = (double)mrc_threshold/(1<<MRC_HASH_BITS);   //Rate actually sampled
+  mrc_depth = 1+(int)((frames-1)*mrc_rate+1e-9);
+  mrc_mini_max = (int)(frames*mrc_rate+0.5);
+  mrc_mini_max = mrc_mini_max<1?1:mrc_mini_max;
+  mrc_stack = (int*)malloc(mrc_depth*sizeof(int));
+  mrc_lru_hits = (long long*)malloc((frames+1)*sizeof(long long));
+  mrc_mini_frames = (int*)malloc(2*3*(size_t)mrc_mini_max*(mrc_mini_max+1)/2*sizeof(int));
+  mrc_mini_use = (unsigned char*)malloc(2*(size_t)mrc_mini_max*(mrc_mini_max+1)/2);
+  for(p=0;p<2;p++){
+    mrc_mini[p] = (struct frame_table*)malloc((mrc_mini_max+1)*sizeof(struct frame_table));
+    mrc_mini_misses[p] = (long long*)malloc((mrc_mini_max+1)*sizeof(long long));
+  }
+  prng_seed(&mrc_rng, seed+2);
+}
+
+/*******************************************************************
+ *void mrc_reset()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It empties estimator before a new stream and picks a new hash salt, so each
+ *             experiment samples a different set of pages.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void mrc_reset(){
+  int p,m;
+  int *frames = mrc_mini_frames;
+  unsigned char *use = mrc_mini_use;
+  mrc_salt = prng_next(&mrc_rng);
+  mrc_stack_size = 0;
+  mrc_sampled = 0;
+  memset(mrc_lru_hits, 0, (mrc_frames+1)*sizeof(long long));
+  memset(mrc_bitmap, 0, sizeof(mrc_bitmap));
+  for(p=0;p<2;p++){
+    for(m=1;m<=mrc_mini_max;m++){
+      frame_table_init(&mrc_mini[p][m], p==0?POLICY_FIFO:POLICY_CLOCK, m, frames, use, NULL, 0);
+      frames += 3*m;
+      use += m;
+      mrc_mini_misses[p][m] = 0;
+    }
+  }
+}
+
+/*******************************************************************
+ *void mrc_reference(int page)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It feeds one reference to estimator. Unsampled pages return after one hash.
+ *             For a sampled page its depth in LRU stack gives smallest LRU cache holding it,
+ *             and miniature FIFO and CLOCK caches are referenced.
+ *Parameters:
+ *int page I/P: Referenced page.
+ *This routine does not return anything.
+ *******************************************************************/
+void mrc_reference(int page){
+  int d,p,m,victim;
+  uint64_t h = ((uint64_t)(unsigned)page ^ mrc_salt)+0x9e3779b97f4a7c15ULL;   //splitmix64 finalizer
+  h = (h^(h>>30))*0xbf58476d1ce4e5b9ULL;
+  h = (h^(h>>27))*0x94d049bb133111ebULL;
+  h ^= h>>31;
+  if((uint32_t)(h>>(64-MRC_HASH_BITS))>=mrc_threshold){
+    return;
+  }
+  mrc_sampled++;
+  mrc_bitmap[(h&(MRC_BITMAP_BITS-1))>>6] |= 1ULL<<(h&63);
+  for(d=0;d<mrc_stack_size && mrc_stack[d]!=page;d++);
+  if(d<mrc_stack_size){
+    int frames = 1+(int)ceil(d/mrc_rate-1e-9);   //d sampled pages between uses stand for d/rate pages
+    if(frames<=mrc_frames){
+      mrc_lru_hits[frames]++;
+    }
+  }else{   //Not seen or deeper than largest cache
+    if(mrc_stack_size<mrc_depth){
+      mrc_stack_size++;
+    }
+    d = mrc_stack_size-1;
+  }
+  memmove(mrc_stack+1, mrc_stack, d*sizeof(int));
+  mrc_stack[0] = page;
+  for(p=0;p<2;p++){
+    for(m=1;m<=mrc_mini_max;m++){
+      mrc_mini_misses[p][m] += frame_table_reference(&mrc_mini[p][m], page, &victim)!=FRAME_HIT;
+    }
+  }
+}
+
+/*******************************************************************
+ *void mrc_estimate(long long references, int lo, int hi, double (*result)[3])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It estimates LRU, FIFO and CLOCK faults of a stream for lo to hi frames. Miss
+ *             ratio of sampled stream is applied to all references and first loads are taken
+ *             off like the simulators do, using distinct pages estimated by linear counting.
+ *Parameters:
+ *long long references I/P: References in stream.
+ *int lo I/P: Smallest frame count.
+ *int hi I/P: Largest frame count, at most mrc_frames.
+ *double (*result)[3] O/P: result[c-lo] gets faults with c frames.
+ *This routine does not return anything.
+ *******************************************************************/
+void mrc_estimate(long long references, int lo, int hi, double (*result)[3]){
+  int c,p,i,zeros=0;
+  long long hits=0;
+  double distinct;
+  for(i=0;i<MRC_BITMAP_BITS/64;i++){
+    zeros += 64-__builtin_popcountll(mrc_bitmap[i]);
+  }
+  distinct = zeros>0?-MRC_BITMAP_BITS*log((double)zeros/MRC_BITMAP_BITS):(double)mrc_sampled;
+  distinct /= mrc_rate;
+  for(c=1;c<lo;c++){
+    hits += mrc_lru_hits[c];
+  }
+  for(c=lo;c<=hi;c++){
+    int mini = (int)(c*mrc_rate+0.5);
+    double ratio[3];
+    mini = mini<1?1:mini;
+    hits += mrc_lru_hits[c];
+    if(mrc_sampled==0){
+      ratio[0] = ratio[1] = ratio[2] = 0;
+    }else{
+      ratio[0] = 1.0-(double)hits/mrc_sampled;
+      ratio[1] = (double)mrc_mini_misses[0][mini]/mrc_sampled;
+      ratio[2] = (double)mrc_mini_misses[1][mini]/mrc_sampled;
+    }
+    for(p=0;p<3;p++){
+      double f = ratio[p]*references-(c<distinct?c:distinct);
+      result[c-lo][p] = f>0?f:0;
+    }
+  }
+}
+
+/*******************************************************************
+ *void mrc_compare(long long exact[WORKING_SETS][POLICIES])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It estimates faults of current address stream from samples and adds estimate
+ *             and its absolute error against exact simulation to totals.
+ *Parameters:
+ *long long exact[WORKING_SETS][POLICIES] I/P: Exact faults of current address stream.
+ *This routine does not return anything.
+ *******************************************************************/
+void mrc_compare(long long exact[WORKING_SETS][POLICIES]){
+  double estimate[WORKING_SETS][3];
+  struct timespec t0,t1;
+  int i,p;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  mrc_reset();
+  for(i=0;i<stream_length;i++){
+    mrc_reference(address[i]);
+  }
+  mrc_estimate(stream_length, 2, 20, estimate);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  mrc_seconds += (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)/1e9;
+  mrc_total_sampled += mrc_sampled;
+  mrc_total_references += stream_length;
+  for(i=0;i<WORKING_SETS;i++){
+    for(p=0;p<3;p++){
+      mrc_faults[i][p] += estimate[i][p];
+      mrc_abs_error[p] += fabs(estimate[i][p]-exact[i][p]);
+    }
+  }
+}
+
+/*******************************************************************
+ *void simulate_mrc_trace()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It streams mrc_trace_length references of selected workload through estimator,
+ *             BULK_SIZE at a time, and prints estimated miss ratio curve. Trace is never
+ *             stored and no exact simulation is done.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void simulate_mrc_trace(){
+  int chunk[BULK_SIZE];
+  long long first;
+  int c,i;
+  struct timespec t0,t1;
+  double (*estimate)[3] = (double(*)[3])malloc(mrc_frames*sizeof(*estimate));
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  mrc_reset();
+  for(first=0;first<mrc_trace_length;first+=BULK_SIZE){
+    int n = mrc_trace_length-first<BULK_SIZE?(int)(mrc_trace_length-first):BULK_SIZE;
+    generate_address_chunk(chunk, first, n);
+    for(i=0;i<n;i++){
+      mrc_reference(chunk[i]);
+    }
+  }
+  mrc_estimate(mrc_trace_length, 1, mrc_frames, estimate);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  mrc_seconds = (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)/1e9;
+  printf("Sampled %lld of %lld references, rate %.4f\n",mrc_sampled,mrc_trace_length,mrc_rate);
+  printf("Frames\tLRU\tFIFO\tCLOCK\t(estimated miss ratio)\n");
+  for(c=1;c<=mrc_frames;c++){
+    printf("%d\t%.4f\t%.4f\t%.4f\n",c,estimate[c-1][0]/mrc_trace_length,estimate[c-1][1]/mrc_trace_length,
+           estimate[c-1][2]/mrc_trace_length);
+  }
+  printf("Estimator time %.3f s, %.1f M references/s\n",mrc_seconds,
+         mrc_seconds>0?mrc_trace_length/mrc_seconds/1e6:0);
+  free(estimate);
+}
+
+/*******************************************************************
+ *void printMrcEstimate()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints average estimated faults next to exact fault matrix and mean absolute
+ *             error of per experiment estimates, in faults and as miss ratio.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void printMrcEstimate(){
+  int i,p;
+  const char *names[3] = {"LRU","FIFO","CLOCK"};
+  printf("Sampled estimate, rate %.4f, %.1f%% of references sampled\n",mrc_rate,
+         mrc_total_references>0?100.0*mrc_total_sampled/mrc_total_references:0);
+  printf("Estimated faults ->             LRU\tFIFO\tCLOCK\n");
+  for(i=0;i<WORKING_SETS;i++){
+    printf("Faults for working set %d is - \t%.0f\t%.0f\t%.0f\n",i+2,mrc_faults[i][0]/experiments,
+           mrc_faults[i][1]/experiments,mrc_faults[i][2]/experiments);
+  }
+  for(p=0;p<3;p++){
+    double mae = mrc_abs_error[p]/((double)experiments*WORKING_SETS);
+    printf("%s mean absolute error %.1f faults, %.4f miss ratio\n",names[p],mae,mae/stream_length);
+  }
+  printf("Estimator time %.3f s\n",mrc_seconds);
+}
+
+/*******************************************************************
+ *void simulatePageFaults()
+ *Author: Prashant Yadav
+ *Date: 10/28/2019
+ *Description: This routine simulates page faults for working set size from 2 to 20 with
+ *             selected engine. In compare mode both engines run on same address stream and
+ *             results of deterministic policies LRU, FIFO and CLOCK are checked to be equal.
+ *             In sampling mode the estimate of same stream is compared with exact faults.
+ *             Working set policies, cost model, prefetchers and TLB hierarchy run on same stream
+ *             when enabled.
+ *             Faults of the experiment are left in experiment_run.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void simulatePageFaults()
+{
+     long long nested_run[WORKING_SETS][POLICIES], fused_run[WORKING_SETS][POLICIES];
+     struct timespec t0,t1;
+     int i,k;
+     generatePageAddresses();
+     memset(nested_run, 0, sizeof(nested_run));
+     memset(fused_run, 0, sizeof(fused_run));
+     if(engine==ENGINE_FUSED || compare_engines){
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        fused_policy_faults(fused_run);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        fused_seconds += (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)/1e9;
+     }
+     if(engine==ENGINE_NESTED || compare_engines){
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        nested_policy_faults(nested_run);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        nested_seconds += (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)/1e9;
+     }
+     for(i=0;i<WORKING_SETS;i++){
+        for(k=0;k<POLICIES;k++){
+          if(compare_engines){
+            fused_faults[i][k] += fused_run[i][k];
+            engine_mismatches += k!=POLICY_RANDOM && nested_run[i][k]!=fused_run[i][k];
+          }
+          faults[i][k] += engine==ENGINE_FUSED?fused_run[i][k]:nested_run[i][k];
+        }
+     }
+     memcpy(experiment_run, engine==ENGINE_FUSED?fused_run:nested_run, sizeof(experiment_run));
+     cell_sample(experiment_run);
+     if(mrc_mode){
+        mrc_compare(engine==ENGINE_FUSED?fused_run:nested_run);
+     }
+     if(cost_mode){
+        cost_policy_faults();
+     }
+     if(prefetch_mode!=PREFETCH_NONE){
+        prefetch_policy_faults();
+     }
+     if(hierarchy_mode){
+        hierarchy_faults();
+     }
+     if(ws_mode){
+        working_set_faults();
+        for(i=0;i<WORKING_SETS;i++){
+          wsclock_faults(i);
+        }
+     }
+}
+
+/*******************************************************************
+ *void inializeFaultMatrix()
+ *Author: Prashant Yadav
+ *Date: 10/28/2019
+ *Description: This routine initializes fault matrix with 0 before simulation and makes every
+ *             cell active.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void inializeFaultMatrix(){
+  int i,k;
+  for(i=0;i<19;i++){
+     faults[i][0]=0;
+     faults[i][1]=0;
+     faults[i][2]=0;
+     faults[i][3]=0;
+     for(k=0;k<POLICIES;k++){
+       memset(&cell_runs[i][k], 0, sizeof(cell_runs[i][k]));
+       cell_active[i][k]=1;
+     }
+  }
+  active_cells=INSTANCES;
+}
+
+/*******************************************************************
+ *void printFaultMatrix()
+ *Author: Prashant Yadav
+ *Date: 10/28/2019
+ *Description: It prints fault matrix.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void printFaultMatrix(){
+  int i;
+  printf("\n------------------------------------------------------------\n");
+  printf("Eviction policy ->              LRU\tFIFO\tCLOCK\tRANDOM\n");
+  for(i=0;i<19;i++){
+    printf("Faults for working set %d is - \t%lld\t%lld\t%lld\t%lld\n",i+2,faults[i][0],faults[i][1],faults[i][2],faults[i][3]);
+  }
+  printf("--------------------------------------------------------------\n");
+}
+
+/*******************************************************************
+ *void printEngineTimes()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints time spent in nested and fused engines. In compare mode it also
+ *             prints average faults of fused engine and number of mismatching results.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void printEngineTimes(){
+  int i;
+  if(compare_engines){
+    printf("Fused engine faults ->          LRU\tFIFO\tCLOCK\tRANDOM\n");
+    for(i=0;i<WORKING_SETS;i++){
+      printf("Faults for working set %d is - \t%lld\t%lld\t%lld\t%lld\n",i+2,fused_faults[i][0]/experiments,
+             fused_faults[i][1]/experiments,fused_faults[i][2]/experiments,fused_faults[i][3]/experiments);
+    }
+    printf("LRU, FIFO and CLOCK results differing between engines: %lld\n",engine_mismatches);
+    printf("Engine time: nested %.3f s, fused %.3f s, speedup %.2fx\n",nested_seconds,fused_seconds,
+           fused_seconds>0?nested_seconds/fused_seconds:0);
+  }else{
+    printf("Engine time: %s %.3f s\n",engine==ENGINE_FUSED?"fused":"nested",
+           engine==ENGINE_FUSED?fused_seconds:nested_seconds);
+  }
+}
+
+/*******************************************************************
+ *void normalizeFaultMatrix()
+ *Author: Prashant Yadav
+ *Date: 10/28/2019
+ *Description: This routine normalizes fault matrix for number of experiments of each cell.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void normalizeFaultMatrix(){
+  int i;
+  for(i=0;i<19;i++){
+    faults[i][0]/=cell_runs[i][0].n;
+    faults[i][1]/=cell_runs[i][1].n;
+    faults[i][2]/=cell_runs[i][2].n;
+    faults[i][3]/=cell_runs[i][3].n;
+  }
+}
+
+/*******************************************************************
+ *void cell_sample(long long run[WORKING_SETS][POLICIES])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It adds faults of one experiment to running statistics of every active cell.
+ *             In adaptive mode a cell whose confidence interval is narrow enough stops.
+ *Parameters:
+ *long long run[WORKING_SETS][POLICIES] I/P: Faults of current experiment.
+ *This routine does not return anything.
+ *******************************************************************/
+void cell_sample(long long run[WORKING_SETS][POLICIES]){
+  int i,k;
+  for(i=0;i<WORKING_SETS;i++){
+    for(k=0;k<POLICIES;k++){
+      struct welford *w = &cell_runs[i][k];
+      if(!cell_active[i][k]){
+        continue;
+      }
+      welford_add(w, (double)run[i][k]);
+      if(ci_width>0 && ci_converged(w->mean, ci_half_width(welford_stddev(w), w->n), w->n, min_runs, ci_width)){
+        cell_active[i][k]=0;
+        active_cells--;
+      }
+    }
+  }
+}
+
+/*******************************************************************
+ *void storedExperiment(int experiment)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It looks up experiment in result store. If store has faults of every active cell
+ *             they are used, otherwise experiment is simulated from its own seed and stored.
+ *             Cells stopped by confidence interval are stored as -1, or as earlier stored value.
+ *Parameters:
+ *int experiment I/P: Experiment number.
+ *This routine does not return anything.
+ *******************************************************************/
+void storedExperiment(int experiment){
+  char text[512];
+  int64_t values[INSTANCES];
+  int i,k,complete=1;
+  uint32_t count=0;
+  snprintf(text, sizeof(text), "scheduling_policy/1 workload=%d pages=%d zipf=%.17g phase=%d/%d stream=%d "
+           "engine=%d seed=%llu experiment=%d",workload,page_space,zipf_exponent,phase_length,phase_pages,
+           stream_length,engine,(unsigned long long)seed,experiment);
+  uint64_t key = store_key(text);
+  const int64_t *cached = store_get(&result_store, key, &count);
+  cached = count==INSTANCES?cached:NULL;
+  for(k=0;k<INSTANCES && cached!=NULL;k++){
+    complete &= !cell_active[k/POLICIES][k%POLICIES] || cached[k]>=0;
+  }
+  if(cached!=NULL && complete){
+    for(k=0;k<INSTANCES;k++){
+      i = k/POLICIES;
+      experiment_run[i][k%POLICIES] = cell_active[i][k%POLICIES]?cached[k]:0;
+      faults[i][k%POLICIES] += experiment_run[i][k%POLICIES];
+      reused_cells += cell_active[i][k%POLICIES];
+    }
+    cell_sample(experiment_run);
+    stored_reused++;
+    return;
+  }
+  prng_seed(&rng, prng_derive(seed, experiment));
+  prng_x4_seed(&bulk_rng, prng_derive(seed+1, experiment));
+  for(k=0;k<INSTANCES;k++){   //Remember which cells are simulated, cell_sample may stop them
+    values[k] = cell_active[k/POLICIES][k%POLICIES]?0:(cached!=NULL?cached[k]:-1);
+  }
+  simulatePageFaults();
+  for(k=0;k<INSTANCES;k++){
+    if(values[k]==0){
+      values[k] = experiment_run[k/POLICIES][k%POLICIES];
+    }
+  }
+  store_put(&result_store, key, values, INSTANCES);
+  stored_computed++;
+}
+
+/*******************************************************************
+ *void printCellRuns()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints experiments each cell needed and half width of 95% confidence interval
+ *             of its mean faults.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void printCellRuns(){
+  int i,k;
+  long long total=0;
+  printf("Experiments per cell ->         LRU\tFIFO\tCLOCK\tRANDOM\t(95%% CI half width)\n");
+  for(i=0;i<WORKING_SETS;i++){
+    printf("Experiments for working set %d is - ",i+2);
+    for(k=0;k<POLICIES;k++){
+      printf("\t%lld",cell_runs[i][k].n);
+      total += cell_runs[i][k].n;
+    }
+    printf("\t(");
+    for(k=0;k<POLICIES;k++){
+      printf("%.2f%s",ci_half_width(welford_stddev(&cell_runs[i][k]),cell_runs[i][k].n),k+1<POLICIES?" ":")\n");
+    }
+  }
+  printf("Cell experiments %lld in %d experiments, %.1f%% of fixed count, target half width %.3g of mean\n",
+         total,experiments,100.0*total/((double)INSTANCES*experiments),ci_width);
+}
+
+/*******************************************************************
+ *void parse_arguments(int argc, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It parses command line options.
+ *             --seed N       Seed of random number stream (default current time).
+ *             --workload W   Address workload: normal (default), uniform, zipf or phased.
+ *             --pages N      Pages of uniform, zipf and phased workloads (default 250).
+ *             --zipf-s S     Exponent of zipf workload (default 1.0).
+ *             --phase-length N  References per phase of phased workload (default 100).
+ *             --phase-pages N   Working set pages of phased workload (default 25).
+ *             --experiments N   Number of experiments (default 1000), upper bound with --ci-width.
+ *             --ci-width R   Stop sampling a cell once 95% confidence interval half width is
+ *                            within R times its mean (default 0, fixed experiment count).
+ *             --min-runs N   Fewest experiments of a cell with --ci-width (default 10).
+ *             --store FILE   Keep fault matrix of every experiment in FILE, reuse experiments
+ *                            found there. Experiments are seeded from seed and their number.
+ *             --stream-length N Addresses in each experiment (default 1000).
+ *             --engine E     Simulation engine: nested (default) or fused.
+ *             --compare-engines  Run both engines on every stream and compare them.
+ *             --mrc          Also estimate faults by sampling and report error against exact faults.
+ *             --sample-rate R    Fraction of pages sampled (default 0.1, with --mrc the smallest
+ *                                rate which keeps MRC_MINI_FEWEST sampled frames of 2 frames).
+ *             --mrc-trace-length N  Only estimate miss ratio curve of one streamed trace of N references.
+ *             --mrc-frames N     Largest frame count of streamed miss ratio curve (default 20).
+ *             --working-set  Also simulate WS(tau) and WSClock with windows step, 2*step, ...
+ *             --ws-step N    Window of first row and step between rows (default 10).
+ *             --cost-model   Also model hit, fault and dirty write back time.
+ *             --write-ratio R    Fraction of references which write (default 0.3).
+ *             --hit-cost N, --fault-cost N, --writeback-cost N  Costs in ns (default 100, 100000, 200000).
+ *             --cleaner-interval N  References between cleaner runs (default 0, no cleaner).
+ *             --cleaner-batch N     Frames cleaner writes in a run (default 4).
+ *             --prefetch P   Also simulate prefetcher P in front of every policy: none
+ *                            (default), fixed, adaptive or stride.
+ *             --readahead N  Pages of fixed and stride prefetch and first adaptive window (default 4).
+ *             --readahead-max N  Largest adaptive readahead window (default 32, at most 256).
+ *             --tlb          Also simulate a TLB in front of page frames.
+ *             --tlb-entries N, --tlb-ways N  TLB size and associativity (default 16 and 4).
+ *             --tlb-policy P, --page-policy P  lru (default), fifo, clock or random.
+ *             --page-frames N    Page frames behind TLB (default 16).
+ *             --tlb-cost N, --walk-cost N  TLB lookup and page walk in ns (default 1 and 30).
+ *             --processes N  Simulate N processes over a shared frame pool instead (at most 64).
+ *             --frames N     Frames in shared pool (default 8 per process).
+ *             --quantum N    References a process makes before next one runs (default 10).
+ *             --threads N    Threads simulating local replacement (default 1).
+ *             --bench        Suppress progress output and print operation count.
+ *Parameters:
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments.
+ *This routine does not return anything.
+ *******************************************************************/
+void parse_arguments(int argc, char *argv[]){
+  int i;
+  seed = (uint64_t)time(0);
+  for(i=1;i<argc;i++){
+    if(strcmp(argv[i],"--seed")==0 && i+1<argc){
+      seed = strtoull(argv[++i], NULL, 0);
+    }else if(strcmp(argv[i],"--workload")==0 && i+1<argc){
+      i++;
+      if(strcmp(argv[i],"normal")==0){
+        workload = WORKLOAD_NORMAL;
+      }else if(strcmp(argv[i],"uniform")==0){
+        workload = WORKLOAD_UNIFORM;
+      }else if(strcmp(argv[i],"zipf")==0){
+        workload = WORKLOAD_ZIPF;
+      }else if(strcmp(argv[i],"phased")==0){
+        workload = WORKLOAD_PHASED;
+      }else{
+        printf("Unknown workload %s\n",argv[i]);
+        exit(1);
+      }
+    }else if(strcmp(argv[i],"--pages")==0 && i+1<argc){
+      page_space = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--zipf-s")==0 && i+1<argc){
+      zipf_exponent = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--phase-length")==0 && i+1<argc){
+      phase_length = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--phase-pages")==0 && i+1<argc){
+      phase_pages = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--experiments")==0 && i+1<argc){
+      experiments = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--stream-length")==0 && i+1<argc){
+      stream_length = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--engine")==0 && i+1<argc){
+      i++;
+      if(strcmp(argv[i],"nested")==0){
+        engine = ENGINE_NESTED;
+      }else if(strcmp(argv[i],"fused")==0){
+        engine = ENGINE_FUSED;
+      }else{
+        printf("Unknown engine %s\n",argv[i]);
+        exit(1);
+      }
+    }else if(strcmp(argv[i],"--compare-engines")==0){
+      compare_engines = 1;
+    }else if(strcmp(argv[i],"--mrc")==0){
+      mrc_mode = 1;
+    }else if(strcmp(argv[i],"--sample-rate")==0 && i+1<argc){
+      mrc_rate = atof(argv[++i]);
+      mrc_rate_set = 1;
+    }else if(strcmp(argv[i],"--mrc-trace-length")==0 && i+1<argc){
+      mrc_trace_length = atoll(argv[++i]);
+    }else if(strcmp(argv[i],"--mrc-frames")==0 && i+1<argc){
+      mrc_frames = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--working-set")==0){
+      ws_mode = 1;
+    }else if(strcmp(argv[i],"--ws-step")==0 && i+1<argc){
+      ws_step = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--cost-model")==0){
+      cost_mode = 1;
+    }else if(strcmp(argv[i],"--write-ratio")==0 && i+1<argc){
+      write_ratio = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--hit-cost")==0 && i+1<argc){
+      hit_cost = atoll(argv[++i]);
+    }else if(strcmp(argv[i],"--fault-cost")==0 && i+1<argc){
+      fault_cost = atoll(argv[++i]);
+    }else if(strcmp(argv[i],"--writeback-cost")==0 && i+1<argc){
+      writeback_cost = atoll(argv[++i]);
+    }else if(strcmp(argv[i],"--cleaner-interval")==0 && i+1<argc){
+      cleaner_interval = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--cleaner-batch")==0 && i+1<argc){
+      cleaner_batch = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--prefetch")==0 && i+1<argc){
+      i++;
+      if(strcmp(argv[i],"none")==0){
+        prefetch_mode = PREFETCH_NONE;
+      }else if(strcmp(argv[i],"fixed")==0){
+        prefetch_mode = PREFETCH_FIXED;
+      }else if(strcmp(argv[i],"adaptive")==0){
+        prefetch_mode = PREFETCH_ADAPTIVE;
+      }else if(strcmp(argv[i],"stride")==0){
+        prefetch_mode = PREFETCH_STRIDE;
+      }else{
+        printf("Unknown prefetcher %s\n",argv[i]);
+        exit(1);
+      }
+    }else if(strcmp(argv[i],"--readahead")==0 && i+1<argc){
+      readahead = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--readahead-max")==0 && i+1<argc){
+      readahead_max = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--tlb")==0){
+      hierarchy_mode = 1;
+    }else if(strcmp(argv[i],"--tlb-entries")==0 && i+1<argc){
+      tlb_entries = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--tlb-ways")==0 && i+1<argc){
+      tlb_ways = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--tlb-policy")==0 && i+1<argc){
+      tlb_policy = parse_policy(argv[++i]);
+    }else if(strcmp(argv[i],"--page-policy")==0 && i+1<argc){
+      page_policy = parse_policy(argv[++i]);
+    }else if(strcmp(argv[i],"--page-frames")==0 && i+1<argc){
+      page_frames = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--tlb-cost")==0 && i+1<argc){
+      tlb_cost = atoll(argv[++i]);
+    }else if(strcmp(argv[i],"--walk-cost")==0 && i+1<argc){
+      walk_cost = atoll(argv[++i]);
+    }else if(strcmp(argv[i],"--processes")==0 && i+1<argc){
+      processes = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--frames")==0 && i+1<argc){
+      shared_frames = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--quantum")==0 && i+1<argc){
+      shared_quantum = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--threads")==0 && i+1<argc){
+      shared_threads = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--ci-width")==0 && i+1<argc){
+      ci_width = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--min-runs")==0 && i+1<argc){
+      min_runs = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--store")==0 && i+1<argc){
+      store_path = argv[++i];
+    }else if(strcmp(argv[i],"--bench")==0){
+      bench_mode = 1;
+    }else{
+      printf("Usage: %s [--seed N] [--workload normal|uniform|zipf|phased] [--pages N]\n"
+             "          [--zipf-s S] [--phase-length N] [--phase-pages N]\n"
+             "          [--experiments N] [--ci-width R] [--min-runs N] [--store FILE]\n"
+             "          [--stream-length N] [--engine nested|fused]\n"
+             "          [--compare-engines] [--mrc] [--sample-rate R]\n"
+             "          [--mrc-trace-length N] [--mrc-frames N] [--working-set]\n"
+             "          [--ws-step N] [--cost-model] [--write-ratio R] [--hit-cost N]\n"
+             "          [--fault-cost N] [--writeback-cost N] [--cleaner-interval N]\n"
+             "          [--cleaner-batch N] [--prefetch none|fixed|adaptive|stride]\n"
+             "          [--readahead N] [--readahead-max N] [--tlb] [--tlb-entries N]\n"
+             "          [--tlb-ways N] [--tlb-policy P] [--page-policy P] [--page-frames N]\n"
+             "          [--tlb-cost N] [--walk-cost N] [--processes N] [--frames N]\n"
+             "          [--quantum N] [--threads N] [--bench]\n",argv[0]);
+      exit(1);
+    }
+  }
+  if(page_space<1 || phase_length<1 || phase_pages<1 || phase_pages>page_space){
+    printf("Invalid workload parameters\n");
+    exit(1);
+  }
+  if(experiments<1 || stream_length<1){
+    printf("Experiments and stream length must be positive\n");
+    exit(1);
+  }
+  if(ci_width<0 || min_runs<2){
+    printf("Confidence interval width must not be negative and min runs at least 2\n");
+    exit(1);
+  }
+  if(ci_width>0 && (compare_engines || mrc_mode)){   //Both compare every cell of every experiment
+    printf("--ci-width can not be combined with --compare-engines or --mrc\n");
+    exit(1);
+  }
+  if(store_path!=NULL && (compare_engines || mrc_mode || cost_mode || prefetch_mode || hierarchy_mode || ws_mode ||
+                          processes>0 || mrc_trace_length>0)){
+    printf("--store only keeps fault matrix, it can not be combined with other simulations\n");
+    exit(1);
+  }
+  if(shared_frames==0){
+    shared_frames = 8*processes;
+  }
+  if(processes<0 || processes>MAX_PROCESSES || (processes>0 && shared_frames<processes) ||
+     shared_quantum<1 || shared_threads<1){
+    printf("Invalid shared frame parameters\n");
+    exit(1);
+  }
+  shared_threads = shared_threads>processes && processes>0?processes:shared_threads;
+  if(write_ratio<0 || write_ratio>1 || hit_cost<0 || fault_cost<0 || writeback_cost<0 ||
+     cleaner_interval<0 || cleaner_batch<1){
+    printf("Invalid cost model parameters\n");
+    exit(1);
+  }
+  write_threshold = (uint64_t)(write_ratio*4294967296.0);
+  if(tlb_ways<1 || tlb_ways>64 || tlb_entries<tlb_ways || tlb_entries%tlb_ways!=0 || page_frames<1 ||
+     tlb_cost<0 || walk_cost<0){
+    printf("TLB entries must be a multiple of 1 to 64 ways\n");
+    exit(1);
+  }
+  tlb_sets = tlb_entries/tlb_ways;
+  if(readahead<1 || readahead_max<readahead || readahead_max>MAX_READAHEAD){
+    printf("Readahead must be at least 1 and at most readahead max, which is at most %d\n",MAX_READAHEAD);
+    exit(1);
+  }
+  if(ws_step<1){
+    printf("Window step must be positive\n");
+    exit(1);
+  }
+  if(mrc_rate<=0 || mrc_rate>1 || mrc_frames<1 || mrc_trace_length<0){
+    printf("Sample rate must be in (0,1] and frames positive\n");
+    exit(1);
+  }
+}
+
+/*******************************************************************
+ *int main(int argc, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 10/28/2019
+ *Description: This is the driver method which simulates fault calculation process for 1000 experiments.
+ *Parameters:
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments, see parse_arguments.
+ *int O/P: It returns 0 on success.
+ *******************************************************************/
+int main(int argc, char *argv[])
+{
+    int experiment,k;
+    long long simulated_cells=0;  //Experiments summed over cells
+    parse_arguments(argc, argv);
+    prng_seed(&rng, seed);
+    prng_x4_seed(&bulk_rng, seed+1);
+    prng_x4_seed(&write_rng, seed+4);
+    prng_seed(&cost_rng, seed+5);
+    prng_seed(&prefetch_rng, seed+7);
+    if(workload==WORKLOAD_ZIPF){
+      build_zipf_table();
+    }
+    printf("Seed %llu\n",(unsigned long long)seed);
+    if(mrc_trace_length>0){   //Estimate only, trace is not kept
+      mrc_init(mrc_frames);
+      simulate_mrc_trace();
+      if(bench_mode){
+        printf("ops=%lld\n",mrc_trace_length);
+      }
+      return 0;
+    }
+    if(mrc_mode){
+      if(!mrc_rate_set){   //Miniature caches of 2 frame column keep MRC_MINI_FEWEST frames
+        mrc_rate = MRC_MINI_FEWEST/2.0<1?MRC_MINI_FEWEST/2.0:1;
+      }else if(2*mrc_rate<MRC_MINI_FEWEST){
+        printf("Warning: rate %.4f samples %.1f frames of 2 frame cache, FIFO and CLOCK estimates are coarse\n",
+               mrc_rate,2*mrc_rate);
+      }
+      mrc_init(20);
+    }
+    if(hierarchy_mode){
+      tlb_tags = (uint32_t*)malloc((size_t)tlb_entries*sizeof(uint32_t));
+      tlb_hand = (unsigned char*)malloc(tlb_sets);
+      tlb_use = (uint64_t*)malloc(tlb_sets*sizeof(uint64_t));
+      hierarchy_store = (int*)malloc(3*(size_t)page_frames*sizeof(int));
+      hierarchy_use = (unsigned char*)malloc(page_frames);
+      prng_seed(&tlb_rng, seed+6);
+      prng_seed(&page_rng, seed+8);
+    }
+    address = (int*)malloc(stream_length*sizeof(int));
+    if(processes>0){
+      simulate_shared_frames();
+      printSharedFrames();
+      if(bench_mode){
+        printf("ops=%lld\n",2LL*POLICIES*processes*experiments*stream_length);
+      }
+      return 0;
+    }
+    inializeFaultMatrix();  //Initialize fault matrix before starting simulations
+    if(store_path!=NULL && store_open(&result_store, store_path)!=0){
+      printf("Can not open store %s\n",store_path);
+      return 1;
+    }
+    for(experiment=0;experiment<experiments && active_cells>0;experiment++)
+    {
+      if(!bench_mode){
+        printf("Starting Simulation for %d\n",experiment+1);
+      }
+      if(store_path!=NULL){
+        storedExperiment(experiment);
+      }else{
+        simulatePageFaults();
+      }
+    }
+    experiments = experiment;   //Experiments actually run, fewer when all cells stopped early
+    for(k=0;k<INSTANCES;k++){
+      simulated_cells += cell_runs[k/POLICIES][k%POLICIES].n;
+    }
+    normalizeFaultMatrix();	//Normalize fault matrix
+    printFaultMatrix();	//Print fault matrix.
+    if(ci_width>0){
+      printCellRuns();
+    }
+    if(store_path!=NULL){
+      printf("Store %s: %lld experiments reused, %lld simulated, %lld records loaded\n",store_path,
+             stored_reused,stored_computed,result_store.loaded);
+      store_close(&result_store);
+    }
+    printEngineTimes();
+    if(mrc_mode){
+      printMrcEstimate();
+    }
+    if(cost_mode){
+      printCostModel();
+    }
+    if(prefetch_mode!=PREFETCH_NONE){
+      printPrefetch();
+    }
+    if(hierarchy_mode){
+      printHierarchy();
+    }
+    if(ws_mode){
+      printWorkingSetPolicies();
+    }
+    if(bench_mode){
+      printf("ops=%lld\n",(simulated_cells-reused_cells)*stream_length);  //References simulated by all policies
+    }
+    return 0;
+}
@@ -5,15 +5,57 @@
  *uniform - It generates numbers uniformly between given high and low values.
  *is_unique - It validates for the uniqueness of generated track sector combination.
  *sort_io_data - It sorts generated io data by tracks in ascending order.
+ *map_io_data - It maps bulk random numbers to track and sector values.
  *generate_io_data - Before each simulation it populates tracks and sectors array with arbitrary values with in specified ranges.
+ *merge_io_data - Merges requests on same track into disk operations before dispatch.
  *print_data - It prints track sector cobination with in a length.
  *get_seek_time - Given current track,sector combination and a target track, sector combination it evaluates total seek time.
+ *hdd_reset - Parks disk head before a batch.
+ *hdd_access - Returns completion time of a request on disk without serving it.
+ *hdd_serve - Moves disk head to a request.
+ *hdd_rewind - Snaps disk head back to track 0.
+ *ssd_bucket_insert - Adds a full flash block to valid count list of its die.
+ *ssd_bucket_remove - Takes a flash block out of its valid count list.
+ *ssd_allocate - Takes next free flash page of a die.
+ *ssd_collect - Collects garbage blocks of a die.
+ *ssd_init - Sizes flash and maps every logical page.
+ *ssd_precondition - Erases flash and writes every logical page once.
+ *ssd_reset - Makes flash dies and channels idle before a batch.
+ *ssd_access - Returns completion time of a request on flash without serving it.
+ *ssd_serve - Serves a read or write on flash.
+ *ssd_rewind - Does nothing, flash has no head.
+ *dispatch_time - Returns when next request can be sent to device.
+ *latency_bucket - Returns latency histogram bucket.
+ *dispatch_done - Records a request sent to device and its latency.
+ *run_order - Serves a service order on device.
  *fifo_disk_scheduling - For a given IO requests it evaluates seek time for FIFO disk scheduing policy.
  *sstf_disk_scheduling - For a given IO requests it evaluates seek time for SSTF disk scheduing policy.
  *scan_disk_scheduling - For a given IO requests it evaluates seek time for SCAN disk scheduing policy.
  *cscan_disk_scheduling - For a given IO requests it evaluates seek time for CSCAN disk scheduing policy.
+ *satf_disk_scheduling - For a given IO requests it evaluates time for shortest access time first policy.
+ *cell_add - Adds time of one batch to statistics of a cell.
+ *cell_stddev - Returns standard deviation of a cell.
  *simulate - This method simulates disk scheduling for all policies for a given set of IO requests 1000 times.
+ *track_index_clear - Empties ordered track index of SCAN or C-SCAN order.
+ *track_index_link - Returns time to serve a request right after another.
+ *track_index_neighbor - Finds nearest occupied position of track index.
+ *track_index_insert - Inserts newest request into track index and returns change of total time.
+ *simulate_incremental - Simulates every length as prefix of one request stream per batch.
+ *trace_parse_line - Parses a request from a line of blkparse output.
+ *trace_open - Opens block trace and tells its format.
+ *trace_next - Reads next request of block trace.
+ *trace_convert - Writes block trace in binary format.
+ *pending_insert - Inserts request into a pending list.
+ *pending_find - Finds request in a pending list.
+ *pending_lower - Finds first pending request on or above a track.
+ *trace_admit - Moves arrived requests of trace to scheduler queue.
+ *replay_trace - Replays block trace with one policy.
+ *simulate_stored - Takes all policies of a length from result store or simulates and stores them.
  *print_matrix - This routine is used to print seek time matrix.
+ *latency_percentile - Returns latency percentile of a policy from its histogram.
+ *print_device_stats - Prints throughput and tail latency of every policy.
+ *parse_arguments - Parses command line options.
+ *allocate_arrays - Allocates request arrays and seek time matrix.
  *main - Driver main routine from where program starts executing. In this routine we simulate disk scheduling for number of IO requests varies from 500 to 1000.
  *******************************************************************/
 #include<stdio.h>
@@ -21,16 +63,158 @@
 #include<time.h>
 #include<string.h>
 #include<math.h>
+#include "../common/prng.h"
+#include "../common/stats.h"
+#include "../common/store.h"
+#define TRACKS 5000        //Tracks are numbered 1 to TRACKS
+#define SECTORS 12000      //Sectors are numbered 1 to SECTORS
 
-int sectors[1000];   //Sector position to perform read
-int tracks[1000];    //Track postions to perform read
-int sorted_sectors[1000]; //Sorted values of sectors by track.
-int sorted_tracks[1000];  //Sorted array by track in ascending order.
+int *sectors;   //Sector position to perform read
+int *tracks;    //Track postions to perform read
+int *sorted_sectors; //Sorted values of sectors by track.
+int *sorted_tracks;  //Sorted array by track in ascending order.
 int length=0;    //Length of IO requests array. varies from 500-1000
-//Each column stores seek time for FIFO, SSTF, SCAN, CSCAN disk scheduling policies.
-//index0 - FIFO, index1 - SSTF, index2 - SCAN, index3 - CSCAN 
-float seek_time[501][4];  
-float tseek = 2,sseek=0.005; //Track seek time 2ms per track, Sector seek time 0.005ms per sector
+int min_length=500, max_length=1000;  //Range of lengths simulated
+int batches=1000;     //Batches of I/O requests simulated for each length
+int bench_mode=0;     //1 to suppress progress output and print operation count at end
+int stats_mode=0;     //1 to print standard deviation, minimum and maximum of every cell
+double ci_width=0;    //Cell stops once 95% confidence interval is within ci_width of its mean, 0 never
+int min_runs=10;      //Fewest batches of a cell before it may stop
+//Each column stores seek time for FIFO, SSTF, SCAN, CSCAN, SATF disk scheduling policies.
+//index0 - FIFO, index1 - SSTF, index2 - SCAN, index3 - CSCAN, index4 - SATF
+//Statistics of one cell of seek time matrix. Times are integer nanoseconds, so sums are exact
+//and same seed gives same results on every machine.
+struct cell_stats{
+  long long n, sum, min, max;
+  __int128 sum_sq;          //Squares of batch times reach 10^24 ns^2
+};
+struct cell_stats (*seek_time)[5];  //One row for each length from min_length to max_length
+const long long tseek = 2000000, sseek = 5000; //Track seek time 2ms per track, Sector seek time 0.005ms per sector, in ns
+#define REWIND_TIME 1500000 //Head snaps back to track 0 in 1.5 ms
+struct prng rng;    //Random number stream for I/O requests
+uint64_t seed;      //Seed of the random number stream
+struct prng_x4 bulk_rng;   //Bulk random number streams for I/O requests
+uint64_t *random_words;
+unsigned int *request_set;  //Track sector keys generated in current batch, 0 is empty
+int request_set_size;       //Power of 2 at least four times max_length
+int *sorted_ids;            //Arrival index of each request in sorted order
+unsigned char *writes;      //1 when request writes
+double write_ratio=0;       //Fraction of requests which write
+struct prng write_rng;      //Random number stream for write flags
+
+//Storage device behind the schedulers. A scheduler only decides order of requests, device
+//turns the order into time, so every scheduler runs against every device. Requests are
+//given by arrival index and times are in nanoseconds.
+struct device{
+  const char *name;
+  void (*reset)(void);                  //Make device idle before a batch
+  long long (*access)(int id, long long now);   //Completion of request started at now, state is kept
+  long long (*serve)(int id, long long now);    //Serve request dispatched at now, return its completion
+  void (*rewind)(long long now);        //Return to first track at now, used by CSCAN
+};
+struct device *device;
+
+#define POLICIES 5          //FIFO, SSTF, SCAN, CSCAN, SATF
+#define ORDER_REWIND -1     //Entry of service order which rewinds device
+int *order;                 //Service order produced by a scheduler
+int queue_depth=1;          //Requests the device may hold at once
+long long *in_flight;           //Completion times of requests on device
+int in_flight_count;
+long long batch_makespan;       //Completion of last request of batch
+#define LATENCY_BUCKETS 512 //8 buckets per power of two microseconds
+long long latency_hist[POLICIES][LATENCY_BUCKETS];
+long long busy_time[POLICIES];  //Sum of batch makespans
+long long served[POLICIES];
+
+//Rotating disk state.
+int head_track, head_sector;
+long long head_free;            //Time head finishes current request
+
+//Flash device. Dies work in parallel and share channels, logical pages are mapped to
+//physical pages by a page mapped FTL and overwrites go to fresh pages, so blocks are
+//garbage collected. Mapping persists over batches, so drive stays in steady state.
+#define SECTORS_PER_PAGE 32
+#define SSD_READ 50000      //Page read on die, ns
+#define SSD_PROGRAM 500000  //Page program on die
+#define SSD_ERASE 3000000   //Block erase
+#define SSD_TRANSFER 10000  //Page transfer on channel
+#define SSD_GC_FREE 2       //Die collects garbage when it has fewer free blocks
+int ssd_channels=8, ssd_dies_per_channel=4, ssd_block_pages=256;
+double ssd_overprovision=0.07;
+int ssd_dies, ssd_die_blocks, ssd_logical_pages;
+int *l2p, *p2l;             //Logical to physical page and back, -1 when unmapped
+int *block_valid;           //Valid pages of each block
+int *bucket_head;           //First full block of each die with each valid count, -1 when none
+int *block_next, *block_prev;    //Links of bucket lists, previous is -2 when block is in none
+int *free_blocks, *free_count;   //Stack of free blocks of each die
+int *active_block, *write_page;  //Block being written on each die and its next page
+int next_die;               //Die taking next host write
+long long *die_free, *channel_free;  //Time each die and channel becomes idle
+long long host_writes=0, gc_writes=0, erases=0;
+void ssd_precondition();
+
+//Merge stage. Requests of a batch may be merged into operations before schedulers see them,
+//tracks and sectors then hold operations and an operation also transfers its extra sectors.
+#define MERGE_NONE 0
+#define MERGE_CONTIGUOUS 1  //Runs of adjacent sectors on a track
+#define MERGE_TRACK 2       //All requests of a track
+const char *merge_names[] = {"none","contiguous","track"};
+int merge_mode=MERGE_NONE;
+int *transfer;              //Sectors operation transfers after its first, 0 for a request
+int *merged;                //Requests merged into operation besides first one
+int *merge_first, *merge_last, *merge_count;  //Operation led by each request, by arrival index
+long long merge_requests=0, merge_operations=0, merge_sectors=0;
+
+//Incremental mode. Lengths are prefixes of one stream per batch, so each request is added to
+//the running totals once. Track index keeps SCAN or C-SCAN order of requests so far: one
+//bitmap bit per occupied position and first and last arrival on each position.
+#define INDEX_POSITIONS (2*TRACKS+2)
+#define INDEX_WORDS ((INDEX_POSITIONS+63)/64)
+int incremental_mode=0;
+struct track_index{
+  int cscan;                    //1 for C-SCAN order, 0 for SCAN order
+  uint64_t used[INDEX_WORDS];   //Occupied positions
+  int first[INDEX_POSITIONS], last[INDEX_POSITIONS];   //Earliest and latest arrival on position
+};
+
+//Trace replay. Requests of a block trace arrive at their trace times instead of in batches.
+//Trace is read in blocks and scheduler holds at most trace_queue pending requests, each in a
+//slot of request arrays and in two lists, by track and by arrival, so memory does not grow
+//with trace. Binary trace is magic and version followed by trace_request records.
+#define TRACE_MAGIC 0x544b4c42u   //"BLKT"
+#define TRACE_WRITE 1             //Flag of a write request
+#define TRACE_BUFFER (1<<20)      //Bytes read from trace at once
+struct trace_request{
+  uint64_t time;            //Arrival in ns
+  uint64_t lba;             //First 512 byte block
+  uint32_t blocks, flags;
+};
+struct pending_request{
+  int track, slot;
+  long long seq;            //Arrival order
+};
+const char *trace_path=NULL, *trace_out=NULL;
+char trace_action='Q';      //blkparse action taken as arrival, Q is queued to block layer
+int sectors_per_track=SECTORS, trace_queue=128;
+FILE *trace_file;
+char *trace_buffer;
+int trace_binary, trace_used, trace_filled;
+uint64_t trace_last_time;
+struct trace_request trace_head;   //Next request of trace, valid when trace_ahead is 1
+int trace_ahead;
+long long trace_seq;
+struct pending_request *by_track, *by_arrival;
+int pending_count;
+int *free_slots, free_count_slots;
+long long *arrival;         //Arrival time of request in each slot
+
+//Result store. With a store every length seeds its streams from seed and length, flash starts
+//preconditioned, and its cells are appended to store, so an interrupted sweep resumes and a
+//sweep over an overlapping length range reuses lengths already simulated.
+#define STORED_FIXED (8*POLICIES+3)   //Values of a length before sparse latency histogram
+const char *store_path=NULL;
+struct store result_store;
+long long stored_reused=0, stored_computed=0, reused_requests=0;
 
 /*******************************************************************
  *int uniform(int lo, int hi)
@@ -44,29 +228,30 @@ float tseek = 2,sseek=0.005; //Track seek time 2ms per track, Sector seek time 0
  *******************************************************************/
 int uniform(int lo, int hi)
 {
-  int x, y=(hi-lo)+1,z=RAND_MAX/y;
-  while(y<=(x=(random()/z)));
-  return x+lo;
+  return lo + (int)prng_bounded(&rng, hi-lo+1);
 }
 
 /*******************************************************************
- *int is_unique(int sec, int track, int index)
+ *int is_unique(int sec, int track)
  *Author: Prashant Yadav
  *Date: 11/12/2019
- *Description: It validates whether given track sector in unique with in given index or not.
+ *Description: It validates whether given track sector is unique in current batch. Generated
+ *             combinations are kept in a hash set, so check does not scan the batch.
  *Parameters:
  *int sec I/P: sector value.
  *int track I/P: track value.
- *int index I/P: Index under which we have to check.
  *int O/P: It returns 0 if value is not unique, 1 otherwise.
  *******************************************************************/
-int is_unique(int sec, int track, int index){
-  int i;
-  for(i=0;i<index;i++){
-    if(sectors[i]==sec && tracks[i]==track){
+int is_unique(int sec, int track){
+  unsigned int key = (unsigned int)track*(SECTORS+1)+sec;
+  unsigned int slot = (key*2654435761u)&(request_set_size-1);
+  while(request_set[slot]!=0){
+    if(request_set[slot]==key){
       return 0;  //Return 0 if track sector combination already exists.
     }
+    slot = (slot+1)&(request_set_size-1);
   }
+  request_set[slot]=key;
   return 1; //Return 1 otherwise.
 }
 
@@ -74,24 +259,47 @@ int is_unique(int sec, int track, int index){
  *void sort_io_data()
  *Author: Prashant Yadav
  *Date: 11/12/2019
- *Description: It sorts track and sector combination by tracks.
+ *Description: It sorts track and sector combination by tracks with counting sort. Requests on
+ *             same track keep their arrival order.
  *Parameters:
  *This routine does not accept anything.
  *This routine does not return anything.
  *******************************************************************/
 void sort_io_data(){
-  int i,j;
+  static int count[TRACKS+2];
+  int i;
+  memset(count, 0, sizeof(count));
   for(i=0;i<length;i++){
-    for(j=0;j<length-i;j++){
-      if(sorted_tracks[j]>sorted_tracks[j+1]){  //Sort track and sector arrays.
-        int temp = sorted_tracks[j+1];
-	sorted_tracks[j+1] = sorted_tracks[j];
-	sorted_tracks[j] = temp;
-	temp = sorted_sectors[j+1];
-	sorted_sectors[j+1] = sorted_sectors[j];
-	sorted_sectors[j] = temp;
-      }
-    }
+    count[tracks[i]+1]++;
+  }
+  for(i=1;i<=TRACKS+1;i++){
+    count[i]+=count[i-1];   //count[t] is first position of track t
+  }
+  for(i=0;i<length;i++){
+    int pos = count[tracks[i]]++;
+    sorted_tracks[pos] = tracks[i];
+    sorted_sectors[pos] = sectors[i];
+    sorted_ids[pos] = i;
+  }
+}
+
+/*******************************************************************
+ *void map_io_data(int first, int n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It draws n random numbers in bulk and maps them to sectors and tracks from
+ *             position first. High half of each number gives sector and low half gives track.
+ *Parameters:
+ *int first I/P: First position to fill.
+ *int n I/P: Number of requests to fill.
+ *This routine does not return anything.
+ *******************************************************************/
+void map_io_data(int first, int n){
+  int i;
+  prng_x4_fill(&bulk_rng, random_words, n);
+  for(i=0;i<n;i++){
+    sectors[first+i] = 1 + (int)(((random_words[i]>>32)*SECTORS)>>32);
+    tracks[first+i]  = 1 + (int)(((random_words[i]&0xffffffffULL)*TRACKS)>>32);
   }
 }
 
@@ -99,28 +307,93 @@ void sort_io_data(){
  *void generate_io_data()
  *Author: Prashant Yadav
  *Date: 11/12/2019
- *Description: It generates unique track and sector combinations.
+ *Description: It generates unique track and sector combinations. Requests are drawn in bulk,
+ *             duplicates are dropped and only the missing requests are drawn again. Write
+ *             flags come from their own stream, so requests do not depend on write ratio.
  *Parameters:
  *This routine does not accept anything.
  *This routine does not return anything.
  *******************************************************************/
 void generate_io_data(){
-  int i=0;
-  srand(time(0));
+  int i=0,j;
+  memset(request_set, 0, request_set_size*sizeof(unsigned int));
   while(i<length){
-    int sector = uniform(1,12000);  //Random value for sector
-    int track  = uniform(1,5000);   //Random value for track
-    if(is_unique(sector, track,i)==1){ //If it is unique populate the array
-      sectors[i] = sector;
-      sorted_sectors[i] = sector;
-      tracks[i] = track;
-      sorted_tracks[i] = track;
-      i++;
+    int n = length-i, last = length;
+    map_io_data(i, n);
+    for(j=i;j<last;j++){
+      if(is_unique(sectors[j], tracks[j])==1){ //If it is unique keep it
+        sectors[i] = sectors[j];
+        tracks[i] = tracks[j];
+        i++;
+      }
     }
  }
+ for(i=0;i<length;i++){
+   writes[i] = write_ratio>0 && (prng_next(&write_rng)>>11)*(1.0/9007199254740992.0)<write_ratio;
+ }
  sort_io_data();  //Sort the data by track
 }
 
+/*******************************************************************
+ *int merge_io_data()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It merges requests of a batch into disk operations the way an elevator merges
+ *             bios before dispatch. Requests of a track are put in sector order and a run of
+ *             adjacent sectors, or with MERGE_TRACK all requests of the track, becomes one
+ *             operation which positions once on its first sector and transfers up to its last.
+ *             Operation takes queue position of its earliest request. Operations replace
+ *             requests in arrays, in arrival order, and are sorted by track again.
+ *Parameters:
+ *This method doesn't accept anything.
+ *int O/P: It returns number of operations.
+ *******************************************************************/
+int merge_io_data(){
+  int i=0,j,k,n=0;
+  while(i<length){
+    for(j=i+1;j<length && sorted_tracks[j]==sorted_tracks[i];j++);
+    for(k=i+1;k<j;k++){   //Sort track by sector, tracks hold few requests
+      int sec = sorted_sectors[k], id = sorted_ids[k], m = k;
+      while(m>i && sorted_sectors[m-1]>sec){
+        sorted_sectors[m] = sorted_sectors[m-1];
+        sorted_ids[m] = sorted_ids[m-1];
+        m--;
+      }
+      sorted_sectors[m] = sec;
+      sorted_ids[m] = id;
+    }
+    for(k=i;k<j;k++){
+      int lead = sorted_ids[k], first = sorted_sectors[k], count = 1;
+      while(k+1<j && (merge_mode==MERGE_TRACK || sorted_sectors[k+1]==sorted_sectors[k]+1)){
+        k++;
+        lead = sorted_ids[k]<lead?sorted_ids[k]:lead;
+        count++;
+      }
+      merge_first[lead] = first;
+      merge_last[lead] = sorted_sectors[k];
+      merge_count[lead] = count;
+    }
+    i = j;
+  }
+  for(i=0;i<length;i++){   //Operations in order of their earliest request
+    if(merge_count[i]>0){
+      tracks[n] = tracks[i];
+      sectors[n] = merge_first[i];
+      transfer[n] = merge_last[i]-merge_first[i];
+      merged[n] = merge_count[i]-1;
+      writes[n] = writes[i];
+      merge_sectors += transfer[n]+1;
+      merge_count[i] = 0;
+      n++;
+    }
+  }
+  merge_requests += length;
+  merge_operations += n;
+  length = n;
+  sort_io_data();
+  return n;
+}
+
 /*******************************************************************
  *void print_data()
  *Author: Prashant Yadav
@@ -138,7 +411,7 @@ void print_data(){
 }
 
 /*******************************************************************
- *float get_seek_time(int tr, int sec, int totr, int tosec)
+ *long long get_seek_time(int tr, int sec, int totr, int tosec)
  *Author: Prashant Yadav
  *Date: 11/12/2019
  *Description: It calculates seek time to move from one position to another
@@ -147,51 +420,498 @@ void print_data(){
  *int sec I/P:Source sector
  *int totr I/P:Destination track
  *int tosec I/P:Destination source
- *float O/P:It returns time taken to move from source to destination
+ *long long O/P:It returns time taken to move from source to destination
  *******************************************************************/
-float get_seek_time(int tr, int sec, int totr, int tosec){
-    float ttime = abs(tr-totr)*tseek; //Track seek time
-    int isec = sec - ((int)(ttime/sseek)%12000);  //Sectors moved with in that time
+long long get_seek_time(int tr, int sec, int totr, int tosec){
+    long long ttime = abs(tr-totr)*tseek; //Track seek time
+    int isec = sec - (int)((ttime/sseek)%SECTORS);  //Sectors moved with in that time
     if(isec<0){
-      isec+=12000;
+      isec+=SECTORS;
     }
     return ttime + abs(tosec - isec)*sseek; //Total time
 }
 
 /*******************************************************************
- *float fifo_disk_scheduling()
+ *void hdd_reset()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It parks head at track 2500, sector 0 with no request in progress.
+ *Parameters:
+ *This method doesn't accept anything.
+ *This method doesn't return anything.
+ *******************************************************************/
+void hdd_reset(){
+  head_track = 2500;
+  head_sector = 0;
+  head_free = 0;
+}
+
+/*******************************************************************
+ *long long hdd_access(int id, long long now)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns when request would complete if started at now. Head serves one
+ *             request at a time, so it starts when head is free. Merged operation positions
+ *             on its first sector and transfers rest of its sectors.
+ *Parameters:
+ *int id I/P: Arrival index of request.
+ *long long now I/P: Dispatch time.
+ *long long O/P: It returns completion time.
+ *******************************************************************/
+long long hdd_access(int id, long long now){
+  long long start = now>head_free?now:head_free;
+  return start + get_seek_time(head_track, head_sector, tracks[id], sectors[id]) + transfer[id]*sseek;
+}
+
+/*******************************************************************
+ *long long hdd_serve(int id, long long now)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It moves head to request and returns its completion time. Head stops on last
+ *             sector of request.
+ *Parameters:
+ *int id I/P: Arrival index of request.
+ *long long now I/P: Dispatch time.
+ *long long O/P: It returns completion time.
+ *******************************************************************/
+long long hdd_serve(int id, long long now){
+  head_free = hdd_access(id, now);
+  head_track = tracks[id];
+  head_sector = sectors[id]+transfer[id];
+  return head_free;
+}
+
+/*******************************************************************
+ *void hdd_rewind(long long now)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It snaps head back to track 0 in 1.5 ms, starting when head is done with its
+ *             last request or at now if head is idle by then.
+ *Parameters:
+ *long long now I/P: Time rewind is issued.
+ *This method doesn't return anything.
+ *******************************************************************/
+void hdd_rewind(long long now){
+  head_free = (now>head_free?now:head_free) + REWIND_TIME;
+  head_track = 0;
+}
+
+/*******************************************************************
+ *void ssd_bucket_insert(int b)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It puts full block at head of list of its die holding blocks with same valid
+ *             count, so garbage collection finds a victim without scanning the die.
+ *Parameters:
+ *int b I/P: Block to insert.
+ *This method doesn't return anything.
+ *******************************************************************/
+void ssd_bucket_insert(int b){
+  int head = (b/ssd_die_blocks)*(ssd_block_pages+1) + block_valid[b];
+  block_prev[b] = -1;
+  block_next[b] = bucket_head[head];
+  if(bucket_head[head]>=0){
+    block_prev[bucket_head[head]] = b;
+  }
+  bucket_head[head] = b;
+}
+
+/*******************************************************************
+ *void ssd_bucket_remove(int b)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It takes block out of its valid count list.
+ *Parameters:
+ *int b I/P: Block to remove, it must be in a list.
+ *This method doesn't return anything.
+ *******************************************************************/
+void ssd_bucket_remove(int b){
+  if(block_prev[b]>=0){
+    block_next[block_prev[b]] = block_next[b];
+  }else{
+    bucket_head[(b/ssd_die_blocks)*(ssd_block_pages+1) + block_valid[b]] = block_next[b];
+  }
+  if(block_next[b]>=0){
+    block_prev[block_next[b]] = block_prev[b];
+  }
+  block_prev[b] = -2;
+}
+
+/*******************************************************************
+ *int ssd_allocate(int die)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It takes next free page of active block of die, opening a free block when
+ *             active one is full.
+ *Parameters:
+ *int die I/P: Die to write.
+ *int O/P: It returns physical page number.
+ *******************************************************************/
+int ssd_allocate(int die){
+  if(write_page[die]==ssd_block_pages){
+    if(active_block[die]>=0){   //Full block becomes a garbage collection candidate
+      ssd_bucket_insert(active_block[die]);
+    }
+    active_block[die] = free_blocks[die*ssd_die_blocks + --free_count[die]];
+    write_page[die] = 0;
+  }
+  return active_block[die]*ssd_block_pages + write_page[die]++;
+}
+
+/*******************************************************************
+ *void ssd_collect(int die)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It collects garbage on die until it has SSD_GC_FREE free blocks. Full block with
+ *             fewest valid pages is picked from lowest non empty valid count list, its valid
+ *             pages are copied to active block and it is erased. Die is busy for all reads,
+ *             programs and the erase.
+ *Parameters:
+ *int die I/P: Die to collect.
+ *This method doesn't return anything.
+ *******************************************************************/
+void ssd_collect(int die){
+  while(free_count[die]<SSD_GC_FREE){
+    int v, victim=-1, p;
+    for(v=0;v<ssd_block_pages && victim<0;v++){   //Full valid blocks reclaim nothing
+      victim = bucket_head[die*(ssd_block_pages+1) + v];
+    }
+    if(victim<0){   //Nothing to reclaim
+      return;
+    }
+    ssd_bucket_remove(victim);
+    for(p=victim*ssd_block_pages;p<(victim+1)*ssd_block_pages;p++){
+      if(p2l[p]>=0){
+        int ppn = ssd_allocate(die);
+        l2p[p2l[p]] = ppn;
+        p2l[ppn] = p2l[p];
+        block_valid[ppn/ssd_block_pages]++;
+        p2l[p] = -1;
+        die_free[die] += SSD_READ + SSD_PROGRAM;
+        gc_writes++;
+      }
+    }
+    block_valid[victim] = 0;
+    free_blocks[die*ssd_die_blocks + free_count[die]++] = victim;
+    die_free[die] += SSD_ERASE;
+    erases++;
+  }
+}
+
+/*******************************************************************
+ *void ssd_init()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It sizes flash for all tracks and sectors plus over provisioning and
+ *             preconditions it.
+ *Parameters:
+ *This method doesn't accept anything.
+ *This method doesn't return anything.
+ *******************************************************************/
+void ssd_init(){
+  ssd_dies = ssd_channels*ssd_dies_per_channel;
+  ssd_logical_pages = (TRACKS*SECTORS+SECTORS_PER_PAGE-1)/SECTORS_PER_PAGE;
+  ssd_die_blocks = (int)ceil(ssd_logical_pages*(1+ssd_overprovision)/ssd_dies/ssd_block_pages)+SSD_GC_FREE+1;
+  long long physical = (long long)ssd_dies*ssd_die_blocks*ssd_block_pages;
+  l2p = (int*)malloc(ssd_logical_pages*sizeof(int));
+  p2l = (int*)malloc(physical*sizeof(int));
+  block_valid = (int*)calloc(ssd_dies*ssd_die_blocks, sizeof(int));
+  bucket_head = (int*)malloc(ssd_dies*(ssd_block_pages+1)*sizeof(int));
+  block_next = (int*)malloc(ssd_dies*ssd_die_blocks*sizeof(int));
+  block_prev = (int*)malloc(ssd_dies*ssd_die_blocks*sizeof(int));
+  free_blocks = (int*)malloc(ssd_dies*ssd_die_blocks*sizeof(int));
+  free_count = (int*)malloc(ssd_dies*sizeof(int));
+  active_block = (int*)malloc(ssd_dies*sizeof(int));
+  write_page = (int*)malloc(ssd_dies*sizeof(int));
+  die_free = (long long*)malloc(ssd_dies*sizeof(long long));
+  channel_free = (long long*)malloc(ssd_channels*sizeof(long long));
+  ssd_precondition();
+}
+
+/*******************************************************************
+ *void ssd_precondition()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It erases all blocks and writes every logical page once, striped over dies, so
+ *             reads always hit mapped pages.
+ *Parameters:
+ *This method doesn't accept anything.
+ *This method doesn't return anything.
+ *******************************************************************/
+void ssd_precondition(){
+  int d,b,i;
+  long long physical = (long long)ssd_dies*ssd_die_blocks*ssd_block_pages;
+  memset(block_valid, 0, ssd_dies*ssd_die_blocks*sizeof(int));
+  for(i=0;i<physical;i++){
+    p2l[i] = -1;
+  }
+  for(i=0;i<ssd_dies*(ssd_block_pages+1);i++){
+    bucket_head[i] = -1;
+  }
+  for(i=0;i<ssd_dies*ssd_die_blocks;i++){
+    block_prev[i] = -2;
+  }
+  for(d=0;d<ssd_dies;d++){   //Free blocks are popped from the end, lowest block first
+    free_count[d] = 0;
+    for(b=(d+1)*ssd_die_blocks-1;b>=d*ssd_die_blocks;b--){
+      free_blocks[d*ssd_die_blocks + free_count[d]++] = b;
+    }
+    write_page[d] = ssd_block_pages;
+    active_block[d] = -1;
+  }
+  for(i=0;i<ssd_logical_pages;i++){
+    int ppn = ssd_allocate(i%ssd_dies);
+    l2p[i] = ppn;
+    p2l[ppn] = i;
+    block_valid[ppn/ssd_block_pages]++;
+  }
+  next_die = 0;
+}
+
+/*******************************************************************
+ *void ssd_reset()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It makes all dies and channels idle. Mapping and garbage are kept.
+ *Parameters:
+ *This method doesn't accept anything.
+ *This method doesn't return anything.
+ *******************************************************************/
+void ssd_reset(){
+  int i;
+  for(i=0;i<ssd_dies;i++){
+    die_free[i] = 0;
+  }
+  for(i=0;i<ssd_channels;i++){
+    channel_free[i] = 0;
+  }
+}
+
+/*******************************************************************
+ *long long ssd_access(int id, long long now)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns when request would complete if started at now. A read senses page
+ *             on its die and moves it over die's channel, a write moves page to next write
+ *             die and programs it. Garbage collection is not included.
+ *Parameters:
+ *int id I/P: Arrival index of request.
+ *long long now I/P: Dispatch time.
+ *long long O/P: It returns completion time.
+ *******************************************************************/
+long long ssd_access(int id, long long now){
+  int die, channel;
+  long long start;
+  if(writes[id]){
+    die = next_die;
+    channel = die%ssd_channels;
+    start = now>channel_free[channel]?now:channel_free[channel];
+    start += SSD_TRANSFER;
+    start = start>die_free[die]?start:die_free[die];
+    return start + SSD_PROGRAM;
+  }
+  int lpn = ((tracks[id]-1)*SECTORS + sectors[id]-1)/SECTORS_PER_PAGE;
+  die = l2p[lpn]/ssd_block_pages/ssd_die_blocks;
+  channel = die%ssd_channels;
+  start = (now>die_free[die]?now:die_free[die]) + SSD_READ;
+  start = start>channel_free[channel]?start:channel_free[channel];
+  return start + SSD_TRANSFER;
+}
+
+/*******************************************************************
+ *long long ssd_serve(int id, long long now)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It serves request on flash and returns its completion time. A write goes to a
+ *             fresh page of next die in turn, old page becomes garbage and die collects
+ *             garbage when it runs low on free blocks.
+ *Parameters:
+ *int id I/P: Arrival index of request.
+ *long long now I/P: Dispatch time.
+ *long long O/P: It returns completion time.
+ *******************************************************************/
+long long ssd_serve(int id, long long now){
+  int lpn = ((tracks[id]-1)*SECTORS + sectors[id]-1)/SECTORS_PER_PAGE;
+  long long done = ssd_access(id, now);
+  if(writes[id]){
+    int die = next_die, old = l2p[lpn], channel = die%ssd_channels;
+    int ppn = ssd_allocate(die);
+    channel_free[channel] = (now>channel_free[channel]?now:channel_free[channel]) + SSD_TRANSFER;
+    die_free[die] = done;
+    p2l[old] = -1;
+    if(block_prev[old/ssd_block_pages]!=-2){   //Full block moves to next lower valid count
+      ssd_bucket_remove(old/ssd_block_pages);
+      block_valid[old/ssd_block_pages]--;
+      ssd_bucket_insert(old/ssd_block_pages);
+    }else{
+      block_valid[old/ssd_block_pages]--;
+    }
+    l2p[lpn] = ppn;
+    p2l[ppn] = lpn;
+    block_valid[ppn/ssd_block_pages]++;
+    host_writes++;
+    next_die = next_die+1==ssd_dies?0:next_die+1;
+    if(free_count[die]<SSD_GC_FREE){
+      ssd_collect(die);
+    }
+  }else{
+    int die = l2p[lpn]/ssd_block_pages/ssd_die_blocks;
+    die_free[die] = done;   //Page register is busy until page leaves over channel
+    channel_free[die%ssd_channels] = done;
+  }
+  return done;
+}
+
+/*******************************************************************
+ *void ssd_rewind(long long now)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: Flash has no head, rewind costs nothing.
+ *Parameters:
+ *long long now I/P: Time rewind is issued, unused.
+ *This method doesn't return anything.
+ *******************************************************************/
+void ssd_rewind(long long now){
+}
+
+struct device hdd_device = {"hdd", hdd_reset, hdd_access, hdd_serve, hdd_rewind};
+struct device ssd_device = {"ssd", ssd_reset, ssd_access, ssd_serve, ssd_rewind};
+
+/*******************************************************************
+ *long long dispatch_time()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns when next request can be sent to device. All requests of a batch
+ *             arrive at time 0, so a request waits only when queue_depth requests are on
+ *             device, until earliest of them completes.
+ *Parameters:
+ *This method doesn't accept anything.
+ *long long O/P: It returns dispatch time.
+ *******************************************************************/
+long long dispatch_time(){
+  int i, first=0;
+  long long now;
+  if(in_flight_count<queue_depth){
+    return 0;
+  }
+  if(queue_depth==1){   //Common case, next request waits for the only one on device
+    in_flight_count = 0;
+    return in_flight[0];
+  }
+  for(i=1;i<in_flight_count;i++){
+    first = in_flight[i]<in_flight[first]?i:first;
+  }
+  now = in_flight[first];
+  in_flight[first] = in_flight[--in_flight_count];
+  return now;
+}
+
+/*******************************************************************
+ *int latency_bucket(long long latency)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns histogram bucket of a latency. Bucket is power of two of microseconds
+ *             and next three bits, so buckets are at most 12.5% wide.
+ *Parameters:
+ *long long latency I/P: Latency in ns.
+ *int O/P: It returns bucket between 0 and LATENCY_BUCKETS-1.
+ *******************************************************************/
+static inline int latency_bucket(long long latency){
+  unsigned long long us = latency/1000;
+  if(us==0){
+    return 0;
+  }
+  int e = 63-__builtin_clzll(us);
+  return 1 + e*8 + (int)((e>=3?us>>(e-3):us<<(3-e))&7);
+}
+
+/*******************************************************************
+ *void dispatch_done(int policy, int id, long long completion)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It records request sent to device and adds its latency to histogram of policy,
+ *             once for every request merged into it.
+ *Parameters:
+ *int policy I/P: Scheduling policy.
+ *int id I/P: Arrival index of request.
+ *long long completion I/P: Completion time, which is also latency as request arrived at 0.
+ *This method doesn't return anything.
+ *******************************************************************/
+void dispatch_done(int policy, int id, long long completion){
+  in_flight[in_flight_count++] = completion;
+  batch_makespan = completion>batch_makespan?completion:batch_makespan;
+  latency_hist[policy][latency_bucket(completion)] += 1+merged[id];
+}
+
+/*******************************************************************
+ *long long run_order(int policy, int n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It serves first n entries of service order on device and returns time when
+ *             last request completes. Disk with queue depth 1 takes a direct path, where each
+ *             request is dispatched when previous one completes.
+ *Parameters:
+ *int policy I/P: Scheduling policy, for latency histogram.
+ *int n I/P: Number of order entries.
+ *long long O/P: It returns time taken to complete all I/O requests
+ *******************************************************************/
+long long run_order(int policy, int n){
+  int i;
+  long long now = 0;
+  device->reset();
+  in_flight_count = 0;
+  batch_makespan = 0;
+  if(device==&hdd_device && queue_depth==1){   //Serial disk, each request starts when last ends
+    for(i=0;i<n;i++){
+      if(order[i]==ORDER_REWIND){
+        hdd_rewind(now);
+      }else{
+        now = hdd_serve(order[i], now);
+        latency_hist[policy][latency_bucket(now)] += 1+merged[order[i]];
+      }
+    }
+    batch_makespan = now;
+    return batch_makespan;
+  }
+  for(i=0;i<n;i++){
+    if(order[i]==ORDER_REWIND){
+      device->rewind(now);
+    }else{
+      now = dispatch_time();
+      dispatch_done(policy, order[i], device->serve(order[i], now));
+    }
+  }
+  return batch_makespan;
+}
+
+/*******************************************************************
+ *long long fifo_disk_scheduling()
  *Author: Prashant Yadav
  *Date: 11/12/2019
  *Description: It calculates total time to server all I/O requests by FIFO Policy.
  *Parameters:
  *This method doesn't accept anything.
- *float O/P:It returns time taken to complete all I/O requests
+ *long long O/P:It returns time taken to complete all I/O requests
  *******************************************************************/
-float fifo_disk_scheduling(){
-  int track_pos=2500, sector_pos=0,i;
-  float time=0;
-  float ttime,sstime;
+long long fifo_disk_scheduling(){
+  int i;
   for(i=0;i<length;i++){ //Iterate over all positions
-    time = time + get_seek_time(track_pos, sector_pos, tracks[i], sectors[i]);
-    track_pos = tracks[i];
-    sector_pos = sectors[i];
+    order[i] = i;
   }
-  return time;
+  return run_order(0, length);
 }
 
 /*******************************************************************
- *float sstf_disk_scheduling()
+ *long long sstf_disk_scheduling()
  *Author: Prashant Yadav
  *Date: 11/12/2019
  *Description: It calculates total time to server all I/O requests by SSTF Policy.
  *Parameters:
  *This method doesn't accept anything.
- *float O/P:It returns time taken to complete all I/O requests
+ *long long O/P:It returns time taken to complete all I/O requests
  *******************************************************************/
-float sstf_disk_scheduling(){
-  int track_pos=2500, sector_pos=0,i;
-  float time=0;
-  float ttime,sstime;
+long long sstf_disk_scheduling(){
+  int track_pos=2500,n=0;
   int p=0,curr, pre, post;
   while(p<length && sorted_tracks[p]<track_pos){p++;}
   if(p==length){
@@ -204,10 +924,8 @@ float sstf_disk_scheduling(){
   pre = curr-1;
   post = curr+1;
   while(1){ //Iterate over Sorted arrays and check with is closer to the current position
-    //printf("%d %d %d\n",pre,curr,post);
-    time = time + get_seek_time(track_pos, sector_pos, sorted_tracks[curr], sorted_sectors[curr]);
+    order[n++] = sorted_ids[curr];
     track_pos = sorted_tracks[curr];
-    sector_pos = sorted_sectors[curr];
     if(pre<0 &&  post>=length){
       break;
     }else if(pre<0){
@@ -222,120 +940,1172 @@ float sstf_disk_scheduling(){
       post = post==curr?post+1:post;
     }
   }
-  return time;
+  return run_order(1, n);
 }
 
 /*******************************************************************
- *float scan_disk_scheduling()
+ *long long scan_disk_scheduling()
  *Author: Prashant Yadav
  *Date: 11/12/2019
  *Description: It calculates total time to server all I/O requests by SCAN Policy.
  *Parameters:
  *This method doesn't accept anything.
- *float O/P:It returns time taken to complete all I/O requests
+ *long long O/P:It returns time taken to complete all I/O requests
  *******************************************************************/
-float scan_disk_scheduling(){
-  int track_pos=2500, sector_pos=0,i;
-  float time=0;
-  float ttime,sstime;
+long long scan_disk_scheduling(){
+  int track_pos=2500,i,n=0;
   int p=0;
   while(p<length && sorted_tracks[p]<track_pos){p++;}
   for(i=p;i<length;i++){
-    time = time + get_seek_time(track_pos, sector_pos, sorted_tracks[i], sorted_sectors[i]);
-    track_pos = sorted_tracks[i];
-    sector_pos = sorted_sectors[i];
+    order[n++] = sorted_ids[i];
   }
   for(i=p-1;i>=0;i--){
-    time = time + get_seek_time(track_pos, sector_pos, sorted_tracks[i], sorted_sectors[i]);
-    track_pos = sorted_tracks[i];
-    sector_pos = sorted_sectors[i];
+    order[n++] = sorted_ids[i];
   }
-  return time;
+  return run_order(2, n);
 }
 
 /*******************************************************************
- *float csan_disk_scheduling()
+ *long long csan_disk_scheduling()
  *Author: Prashant Yadav
  *Date: 11/12/2019
  *Description: It calculates total time to server all I/O requests by CSCAN Policy.
  *Parameters:
  *This method doesn't accept anything.
- *float O/P:It returns time taken to complete all I/O requests
+ *long long O/P:It returns time taken to complete all I/O requests
  *******************************************************************/
-float csan_disk_scheduling(){
-  int track_pos=2500, sector_pos=0,i;
-  float time=0;float ttime,sstime;
+long long csan_disk_scheduling(){
+  int track_pos=2500,i,n=0;
   int p=0;
   while(p<length && sorted_tracks[p]<track_pos){p++;}
   for(i=p;i<length;i++){
-    time = time + get_seek_time(track_pos, sector_pos, sorted_tracks[i], sorted_sectors[i]);
-    track_pos = sorted_tracks[i];
-    sector_pos = sorted_sectors[i];
+    order[n++] = sorted_ids[i];
   }
-  time = time + 1.5; //Snap the head back to 0
+  order[n++] = ORDER_REWIND; //Snap the head back to 0
   for(i=0;i<p;i++){
-    time = time + get_seek_time(track_pos, sector_pos, sorted_tracks[i], sorted_sectors[i]);
-    track_pos = sorted_tracks[i];
-    sector_pos = sorted_sectors[i];
+    order[n++] = sorted_ids[i];
   }
-  return time;
+  return run_order(3, n);
+}
+
+/*******************************************************************
+ *long long satf_disk_scheduling()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It calculates total time to serve all I/O requests by shortest access time
+ *             first. Device sees queue_depth oldest waiting requests and each time it can take
+ *             one it starts the one device would complete first. With queue depth 1 it is FIFO.
+ *Parameters:
+ *This method doesn't accept anything.
+ *long long O/P:It returns time taken to complete all I/O requests
+ *******************************************************************/
+long long satf_disk_scheduling(){
+  int i,n=0,next=0,window=0;
+  device->reset();
+  in_flight_count = 0;
+  batch_makespan = 0;
+  while(n<length){
+    long long now = dispatch_time(), best_time=0;
+    int best=0;
+    while(window<queue_depth && next<length){   //Fill window in arrival order
+      order[window++] = next++;
+    }
+    for(i=0;i<window && window>1;i++){   //A single waiting request is taken as is
+      long long t = device->access(order[i], now);
+      if(i==0 || t<best_time){
+        best = i;
+        best_time = t;
+      }
+    }
+    dispatch_done(4, order[best], device->serve(order[best], now));
+    order[best] = order[--window];
+    n++;
+  }
+  return batch_makespan;
+}
+
+/*******************************************************************
+ *void cell_add(struct cell_stats *c, long long t)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It adds time of one batch to statistics of a cell.
+ *Parameters:
+ *struct cell_stats *c I/P: Cell of seek time matrix.
+ *long long t I/P: Time of batch in ns.
+ *This method doesn't return anything.
+ *******************************************************************/
+void cell_add(struct cell_stats *c, long long t){
+  c->min = c->n==0 || t<c->min?t:c->min;
+  c->max = c->n==0 || t>c->max?t:c->max;
+  c->n++;
+  c->sum += t;
+  c->sum_sq += (__int128)t*t;
+}
+
+/*******************************************************************
+ *double cell_stddev(struct cell_stats *c)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns sample standard deviation of a cell. Numerator n*sum_sq-sum^2 is
+ *             formed exactly in 128 bits before it is converted.
+ *Parameters:
+ *struct cell_stats *c I/P: Cell of seek time matrix.
+ *double O/P: It returns standard deviation in ns.
+ *******************************************************************/
+double cell_stddev(struct cell_stats *c){
+  if(c->n<2){
+    return 0;
+  }
+  __int128 num = (__int128)c->n*c->sum_sq - (__int128)c->sum*c->sum;
+  return sqrt((double)num/((double)c->n*(c->n-1)));
 }
 
 /*******************************************************************
  *void simulate()
  *Author: Prashant Yadav
  *Date: 11/12/2019
- *Description: It simulates disk scheduling for given I\O requests by four policies namely FIFO,SSTF,SCAN and CSCAN.
+ *Description: It simulates disk scheduling for given I\O requests by five policies namely FIFO,SSTF,SCAN,CSCAN and SATF.
+ *             With ci_width a policy stops once confidence interval of its cell is narrow enough
+ *             and length is done when every policy stopped. With merge_mode policies schedule
+ *             merged operations of each batch.
  *Parameters:
  *This method doesn't accept anything.
  *This method doesn't return anything.
  *******************************************************************/
 void simulate(){
-  int i;
-  for(i=0;i<1000;i++){
+  //FIFO, SSTF, SCAN, CSCAN and SATF, in order of matrix columns.
+  long long (*const schedulers[POLICIES])(void) = {fifo_disk_scheduling, sstf_disk_scheduling,
+    scan_disk_scheduling, csan_disk_scheduling, satf_disk_scheduling};
+  struct cell_stats *row = seek_time[length-min_length];
+  int active[POLICIES], remaining=POLICIES;
+  int i,k;
+  for(k=0;k<POLICIES;k++){
+    active[k] = 1;
+  }
+  int requests = length;
+  for(i=0;i<batches && remaining>0;i++){
     generate_io_data(); //Generate random I/O Requests
     //print_data();
-    seek_time[length-500][0]+=(float)(fifo_disk_scheduling()); //Simulate for FIFO
-    seek_time[length-500][1]+=(float)(sstf_disk_scheduling()); //Simulate for SSTF
-    seek_time[length-500][2]+=(float)(scan_disk_scheduling()); //Simulate for SCAN
-    seek_time[length-500][3]+=(float)(csan_disk_scheduling()); //Simulate for CSCAN
+    if(merge_mode!=MERGE_NONE){
+      merge_io_data();
+    }
+    for(k=0;k<POLICIES;k++){
+      if(!active[k]){
+        continue;
+      }
+      long long t = schedulers[k]();
+      cell_add(&row[k], t);
+      busy_time[k] += t;
+      served[k] += requests;
+      if(ci_width>0 && ci_converged((double)row[k].sum/row[k].n, ci_half_width(cell_stddev(&row[k]),row[k].n),
+                                    row[k].n, min_runs, ci_width)){
+        active[k] = 0;
+        remaining--;
+      }
+    }
+    length = requests;
+  }
+}
+
+/*******************************************************************
+ *void track_index_clear(struct track_index *x, int cscan)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It empties a track index for SCAN or C-SCAN order.
+ *Parameters:
+ *struct track_index *x I/P: Index to clear.
+ *int cscan I/P: 1 for C-SCAN order, 0 for SCAN order.
+ *This method doesn't return anything.
+ *******************************************************************/
+void track_index_clear(struct track_index *x, int cscan){
+  x->cscan = cscan;
+  memset(x->used, 0, sizeof(x->used));
+}
+
+/*******************************************************************
+ *long long track_index_link(struct track_index *x, int a, int b)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns time to serve request b right after request a. In C-SCAN order the
+ *             step from upper tracks to lower tracks includes rewind of the head.
+ *Parameters:
+ *struct track_index *x I/P: Index giving the order.
+ *int a I/P: Arrival index of earlier request, -1 for parked head.
+ *int b I/P: Arrival index of later request.
+ *long long O/P: It returns time in ns.
+ *******************************************************************/
+long long track_index_link(struct track_index *x, int a, int b){
+  int track = a<0?2500:tracks[a], sector = a<0?0:sectors[a];
+  if(x->cscan && tracks[b]<2500 && track>=2500){
+    return REWIND_TIME + get_seek_time(0, sector, tracks[b], sectors[b]);
+  }
+  return get_seek_time(track, sector, tracks[b], sectors[b]);
+}
+
+/*******************************************************************
+ *int track_index_neighbor(struct track_index *x, int v, int dir)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds nearest occupied position below or above v in the bitmap.
+ *Parameters:
+ *struct track_index *x I/P: Index to search.
+ *int v I/P: Position to start from, not included.
+ *int dir I/P: -1 to search below, 1 to search above.
+ *int O/P: It returns position or -1 if there is none.
+ *******************************************************************/
+int track_index_neighbor(struct track_index *x, int v, int dir){
+  int w;
+  uint64_t bits;
+  if(dir<0){
+    if(v==0){
+      return -1;
+    }
+    w = (v-1)>>6;
+    bits = x->used[w] & (~0ULL>>(63-((v-1)&63)));
+    while(bits==0){
+      if(--w<0){
+        return -1;
+      }
+      bits = x->used[w];
+    }
+    return w*64 + 63-__builtin_clzll(bits);
+  }
+  if(v+1>=INDEX_POSITIONS){
+    return -1;
+  }
+  w = (v+1)>>6;
+  bits = x->used[w] & (~0ULL<<((v+1)&63));
+  while(bits==0){
+    if(++w>=INDEX_WORDS){
+      return -1;
+    }
+    bits = x->used[w];
+  }
+  return w*64 + __builtin_ctzll(bits);
+}
+
+/*******************************************************************
+ *long long track_index_insert(struct track_index *x, int id)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It inserts newest request into service order and returns how much total
+ *             service time grows. Positions 0..TRACKS hold tracks from 2500 up, served in
+ *             arrival order. Positions above hold lower tracks, in SCAN order going down with
+ *             latest arrival first, in C-SCAN order going up after the rewind. New request
+ *             goes between its two neighbors in order, so only three links change.
+ *Parameters:
+ *struct track_index *x I/P: Index of SCAN or C-SCAN order.
+ *int id I/P: Arrival index of request, larger than all requests in index.
+ *long long O/P: It returns change of total time in ns.
+ *******************************************************************/
+long long track_index_insert(struct track_index *x, int id){
+  int t = tracks[id], v, pred, succ, p;
+  int down = !x->cscan && t<2500;   //Group served latest arrival first
+  if(t>=2500){
+    v = t;
+  }else{
+    v = x->cscan?TRACKS+1+t:TRACKS+1+(2499-t);
+  }
+  int occupied = (x->used[v>>6]>>(v&63))&1;
+  if(occupied && !down){        //Goes after last arrival on its track
+    pred = x->last[v];
+    p = track_index_neighbor(x, v, 1);
+    succ = p<0?-1:(p>TRACKS && !x->cscan?x->last[p]:x->first[p]);
+  }else{
+    p = track_index_neighbor(x, v, -1);
+    pred = p<0?-1:(p>TRACKS && !x->cscan?x->first[p]:x->last[p]);
+    if(occupied){               //Goes before earlier arrivals on its track
+      succ = x->last[v];
+    }else{
+      p = track_index_neighbor(x, v, 1);
+      succ = p<0?-1:(p>TRACKS && !x->cscan?x->last[p]:x->first[p]);
+    }
+  }
+  if(!occupied){
+    x->used[v>>6] |= 1ULL<<(v&63);
+    x->first[v] = id;
+  }
+  x->last[v] = id;
+  long long delta = track_index_link(x, pred, id);
+  if(succ>=0){
+    delta += track_index_link(x, id, succ) - track_index_link(x, pred, succ);
+  }
+  return delta;
+}
+
+/*******************************************************************
+ *void simulate_incremental()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It simulates all lengths at once. Every batch draws max_length requests and
+ *             lengths are its prefixes, which are uniform unique requests like batches drawn
+ *             for each length. FIFO total grows by one link per request, SCAN and C-SCAN
+ *             totals by the links track index changes, and SATF equals FIFO on a serial
+ *             disk. SSTF route changes with every request, so it is planned again per length.
+ *Parameters:
+ *This method doesn't accept anything.
+ *This method doesn't return anything.
+ *******************************************************************/
+void simulate_incremental(){
+  static struct track_index scan_index, cscan_index;
+  int b,i,k;
+  for(b=0;b<batches;b++){
+    long long fifo=0, scan=0, cscan=0;
+    length = max_length;
+    generate_io_data();
+    track_index_clear(&scan_index, 0);
+    track_index_clear(&cscan_index, 1);
+    for(i=0;i<max_length;i++){
+      fifo += track_index_link(&scan_index, i-1, i);
+      scan += track_index_insert(&scan_index, i);
+      cscan += track_index_insert(&cscan_index, i);
+      if(i+1<min_length){
+        continue;
+      }
+      long long t[POLICIES];
+      length = i+1;
+      sort_io_data();
+      t[0] = fifo;
+      t[1] = sstf_disk_scheduling();
+      t[2] = scan;
+      t[3] = cscan;
+      t[4] = fifo;
+      for(k=0;k<POLICIES;k++){
+        cell_add(&seek_time[length-min_length][k], t[k]);
+        busy_time[k] += t[k];
+        served[k] += length;
+      }
+    }
+  }
+}
+
+/*******************************************************************
+ *int trace_parse_line(char *line, struct trace_request *r)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It parses one line of blkparse output, e.g.
+ *             "  8,0    3       11     0.009507758   697  Q   W 223490 + 8 [kjournald]",
+ *             which is device, cpu, sequence, seconds, pid, action, RWBS, sector, +, blocks.
+ *             Lines of other actions, summary lines and requests without data are skipped.
+ *             Seconds are parsed as integer nanoseconds.
+ *Parameters:
+ *char *line I/P: Line without newline.
+ *struct trace_request *r O/P: Request of line.
+ *int O/P: It returns 1 when line is a request, 0 otherwise.
+ *******************************************************************/
+int trace_parse_line(char *line, struct trace_request *r){
+  char *field[10];
+  int n=0;
+  char *p = line;
+  while(n<10){
+    while(*p==' ' || *p=='\t'){
+      p++;
+    }
+    if(*p=='\0'){
+      return 0;
+    }
+    field[n++] = p;
+    while(*p!=' ' && *p!='\t' && *p!='\0'){
+      p++;
+    }
+  }
+  if(field[5][0]!=trace_action || (field[5][1]!=' ' && field[5][1]!='\t') || field[8][0]!='+'){
+    return 0;
+  }
+  unsigned long long seconds=0, nanoseconds=0;
+  int digits=0;
+  for(p=field[3];*p>='0' && *p<='9';p++){
+    seconds = seconds*10 + (*p-'0');
+  }
+  if(*p=='.'){
+    for(p++;*p>='0' && *p<='9' && digits<9;p++,digits++){
+      nanoseconds = nanoseconds*10 + (*p-'0');
+    }
+  }
+  for(;digits<9;digits++){
+    nanoseconds *= 10;
+  }
+  r->time = seconds*1000000000ULL + nanoseconds;
+  r->lba = strtoull(field[7], NULL, 10);
+  r->blocks = (uint32_t)strtoul(field[9], NULL, 10);
+  r->flags = 0;
+  for(p=field[6];*p!=' ' && *p!='\t' && *p!='\0';p++){
+    r->flags |= *p=='W'?TRACE_WRITE:0;
+  }
+  return r->blocks>0;
+}
+
+/*******************************************************************
+ *int trace_open()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It opens trace file, or goes back to its start, and tells binary trace from
+ *             blkparse text by its magic number.
+ *Parameters:
+ *This method doesn't accept anything.
+ *int O/P: It returns 0 on success and -1 if file can not be read.
+ *******************************************************************/
+int trace_open(){
+  uint32_t head[2];
+  if(trace_file==NULL){
+    trace_file = fopen(trace_path, "rb");
+    if(trace_file==NULL){
+      return -1;
+    }
+    trace_buffer = (char*)malloc(TRACE_BUFFER);
+  }
+  rewind(trace_file);
+  trace_binary = fread(head, sizeof(head), 1, trace_file)==1 && head[0]==TRACE_MAGIC && head[1]==1;
+  if(!trace_binary){
+    rewind(trace_file);
+  }
+  trace_used = trace_filled = 0;
+  trace_last_time = 0;
+  return 0;
+}
+
+/*******************************************************************
+ *int trace_next(struct trace_request *r)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It reads next request of trace. File is read in TRACE_BUFFER blocks, so memory
+ *             stays same for any trace length. Times going back, as blkparse may print events
+ *             of different CPUs, are raised to time of previous request.
+ *Parameters:
+ *struct trace_request *r O/P: Next request.
+ *int O/P: It returns 1 for a request, 0 at end of trace.
+ *******************************************************************/
+int trace_next(struct trace_request *r){
+  while(1){
+    if(trace_binary){
+      if(trace_used+(int)sizeof(*r)>trace_filled){
+        trace_filled = (int)fread(trace_buffer, sizeof(*r), TRACE_BUFFER/sizeof(*r), trace_file)*(int)sizeof(*r);
+        trace_used = 0;
+        if(trace_filled==0){
+          return 0;
+        }
+      }
+      memcpy(r, trace_buffer+trace_used, sizeof(*r));
+      trace_used += sizeof(*r);
+      if(r->blocks==0){
+        continue;
+      }
+    }else{
+      char *line = trace_buffer+trace_used;
+      char *end = memchr(line, '\n', trace_filled-trace_used);
+      if(end==NULL){
+        int left = trace_filled-trace_used;   //Partial line goes to start of buffer
+        memmove(trace_buffer, line, left);
+        trace_used = 0;
+        trace_filled = left + (int)fread(trace_buffer+left, 1, TRACE_BUFFER-1-left, trace_file);
+        if(trace_filled==left){
+          if(left==0){
+            return 0;
+          }
+          trace_buffer[trace_filled++] = '\n';   //Last line without newline
+        }else if(trace_filled==TRACE_BUFFER-1 && memchr(trace_buffer, '\n', trace_filled)==NULL){
+          trace_filled = 0;   //Line longer than buffer is dropped
+        }
+        continue;
+      }
+      *end = '\0';
+      trace_used = (int)(end-trace_buffer)+1;
+      if(!trace_parse_line(line, r)){
+        continue;
+      }
+    }
+    r->time = r->time>trace_last_time?r->time:trace_last_time;
+    trace_last_time = r->time;
+    return 1;
+  }
+}
+
+/*******************************************************************
+ *int trace_convert(const char *out)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It writes requests of trace to a binary trace, magic and version followed by
+ *             24 byte records of time in ns, first block, blocks and flags.
+ *Parameters:
+ *const char *out I/P: Binary trace to write.
+ *int O/P: It returns number of requests written, -1 on error.
+ *******************************************************************/
+int trace_convert(const char *out){
+  static struct trace_request records[TRACE_BUFFER/sizeof(struct trace_request)];
+  const uint32_t head[2] = {TRACE_MAGIC, 1};
+  int n=0, total=0;
+  FILE *file;
+  if(trace_open()!=0){   //Input is opened first, so no empty output is left behind
+    return -1;
+  }
+  file = fopen(out, "wb");
+  if(file==NULL){
+    return -1;
+  }
+  fwrite(head, sizeof(head), 1, file);
+  while(trace_next(&records[n])){
+    total++;
+    if(++n==(int)(sizeof(records)/sizeof(records[0]))){
+      fwrite(records, sizeof(records[0]), n, file);
+      n = 0;
+    }
+  }
+  fwrite(records, sizeof(records[0]), n, file);
+  return fclose(file)==0?total:-1;
+}
+
+/*******************************************************************
+ *void pending_insert(struct pending_request *list, int n, struct pending_request x, int by_track)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It inserts request into a pending list. New request arrived last, so it goes
+ *             after requests of its track, or at end of arrival ordered list.
+ *Parameters:
+ *struct pending_request *list I/P: List of n requests.
+ *int n I/P: Requests in list.
+ *struct pending_request x I/P: Request to insert.
+ *int by_track I/P: 1 when list is ordered by track.
+ *This method doesn't return anything.
+ *******************************************************************/
+void pending_insert(struct pending_request *list, int n, struct pending_request x, int by_track){
+  int lo=0, hi=n;
+  while(by_track && lo<hi){
+    int mid = (lo+hi)/2;
+    if(list[mid].track<=x.track){
+      lo = mid+1;
+    }else{
+      hi = mid;
+    }
+  }
+  memmove(list+hi+1, list+hi, (n-hi)*sizeof(*list));
+  list[hi] = x;
+}
+
+/*******************************************************************
+ *int pending_find(struct pending_request *list, int n, struct pending_request x, int by_track)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It finds position of request in a pending list by binary search, lists are
+ *             ordered by track and arrival or by arrival only.
+ *Parameters:
+ *struct pending_request *list I/P: List of n requests.
+ *int n I/P: Requests in list.
+ *struct pending_request x I/P: Request to find, it is in list.
+ *int by_track I/P: 1 when list is ordered by track.
+ *int O/P: It returns position.
+ *******************************************************************/
+int pending_find(struct pending_request *list, int n, struct pending_request x, int by_track){
+  int lo=0, hi=n;
+  while(lo<hi){
+    int mid = (lo+hi)/2;
+    if((by_track && list[mid].track<x.track) || ((!by_track || list[mid].track==x.track) && list[mid].seq<x.seq)){
+      lo = mid+1;
+    }else{
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/*******************************************************************
+ *int pending_lower(int track)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns position of first pending request on track or above.
+ *Parameters:
+ *int track I/P: Track to look from.
+ *int O/P: It returns position, pending_count when there is none.
+ *******************************************************************/
+int pending_lower(int track){
+  int lo=0, hi=pending_count;
+  while(lo<hi){
+    int mid = (lo+hi)/2;
+    if(by_track[mid].track<track){
+      lo = mid+1;
+    }else{
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/*******************************************************************
+ *void trace_admit(long long now)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It moves requests which arrived by now from trace to pending lists while
+ *             scheduler queue has room. A request which finds queue full waits in trace, so its
+ *             latency includes that wait. Request is mapped to a free slot of request arrays:
+ *             track and sector by geometry, blocks after its first by transfer, up to end of
+ *             track.
+ *Parameters:
+ *long long now I/P: Current time.
+ *This method doesn't return anything.
+ *******************************************************************/
+void trace_admit(long long now){
+  while(pending_count<trace_queue && trace_ahead && (long long)trace_head.time<=now){
+    int slot = free_slots[--free_count_slots];
+    long long offset = (long long)(trace_head.lba%sectors_per_track);
+    struct pending_request x;
+    tracks[slot] = 1 + (int)((trace_head.lba/sectors_per_track)%TRACKS);
+    sectors[slot] = 1 + (int)offset;
+    transfer[slot] = (int)(trace_head.blocks<sectors_per_track-offset?trace_head.blocks:sectors_per_track-offset) - 1;
+    writes[slot] = (trace_head.flags&TRACE_WRITE)!=0;
+    arrival[slot] = (long long)trace_head.time;
+    x.track = tracks[slot];
+    x.slot = slot;
+    x.seq = trace_seq++;
+    pending_insert(by_track, pending_count, x, 1);
+    pending_insert(by_arrival, pending_count, x, 0);
+    pending_count++;
+    trace_ahead = trace_next(&trace_head);
   }
 }
 
+/*******************************************************************
+ *void replay_trace(int policy)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It replays trace with one policy. Requests arrive at their trace times and
+ *             whenever device can take a request policy picks one of pending requests:
+ *             FIFO oldest, SSTF nearest track, SCAN next track in direction of sweep, CSCAN
+ *             next track upwards or rewinds to lowest one, SATF fastest of queue_depth oldest.
+ *             Device is idle until next arrival when nothing is pending. Latency of request
+ *             is its completion less its arrival.
+ *Parameters:
+ *int policy I/P: Scheduling policy.
+ *This method doesn't return anything.
+ *******************************************************************/
+void replay_trace(int policy){
+  long long now=0, first_arrival, last_completion=0, n=0;
+  int head=2500, up=1, i, pos=0;
+  trace_open();
+  trace_ahead = trace_next(&trace_head);
+  first_arrival = trace_ahead?(long long)trace_head.time:0;
+  pending_count = 0;
+  free_count_slots = trace_queue;
+  for(i=0;i<trace_queue;i++){
+    free_slots[i] = i;
+  }
+  if(device==&ssd_device){
+    ssd_precondition();   //Every policy starts from same flash state
+  }
+  device->reset();
+  in_flight_count = 0;
+  while(1){
+    long long ready = dispatch_time();
+    now = ready>now?ready:now;
+    trace_admit(now);
+    if(pending_count==0){
+      if(!trace_ahead){
+        break;
+      }
+      now = (long long)trace_head.time>now?(long long)trace_head.time:now;
+      trace_admit(now);
+    }
+    if(policy==0){
+      pos = pending_find(by_track, pending_count, by_arrival[0], 1);
+    }else if(policy==1){
+      int above = pending_lower(head);
+      if(above==pending_count || (above>0 && head-by_track[above-1].track<=by_track[above].track-head)){
+        pos = pending_lower(by_track[above-1].track);
+      }else{
+        pos = above;
+      }
+    }else if(policy==2){
+      pos = pending_lower(head);
+      up = up && pos<pending_count;   //Nothing above, sweep turns down
+      if(!up){
+        int above = pending_lower(head+1);
+        if(above==0){   //Nothing at or below head, sweep turns up
+          up = 1;
+        }else{
+          pos = pending_lower(by_track[above-1].track);
+        }
+      }
+    }else if(policy==3){
+      pos = pending_lower(head);
+      if(pos==pending_count){
+        device->rewind(now);
+        pos = 0;
+      }
+    }else{
+      long long best_time=0;
+      int best=0, window = pending_count<queue_depth?pending_count:queue_depth;
+      for(i=0;i<window && window>1;i++){
+        long long t = device->access(by_arrival[i].slot, now);
+        if(i==0 || t<best_time){
+          best = i;
+          best_time = t;
+        }
+      }
+      pos = pending_find(by_track, pending_count, by_arrival[best], 1);
+    }
+    struct pending_request x = by_track[pos];
+    i = pending_find(by_arrival, pending_count, x, 0);
+    memmove(by_track+pos, by_track+pos+1, (pending_count-pos-1)*sizeof(*by_track));
+    memmove(by_arrival+i, by_arrival+i+1, (pending_count-i-1)*sizeof(*by_arrival));
+    pending_count--;
+    free_slots[free_count_slots++] = x.slot;
+    head = x.track;
+    long long completion = device->serve(x.slot, now);
+    in_flight[in_flight_count++] = completion;
+    last_completion = completion>last_completion?completion:last_completion;
+    latency_hist[policy][latency_bucket(completion-arrival[x.slot])]++;
+    n++;
+  }
+  busy_time[policy] += n>0?last_completion-first_arrival:0;
+  served[policy] += n;
+}
+
+/*******************************************************************
+ *void simulate_stored()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It looks up current length in result store. A stored length is added to seek
+ *             time matrix, device totals and latency histograms. Otherwise length is simulated
+ *             from its own seed on a freshly preconditioned device and stored as cell stats,
+ *             busy time and requests of every policy, flash counters and nonzero latency
+ *             buckets as bucket index and count pairs.
+ *Parameters:
+ *This method doesn't accept anything.
+ *This method doesn't return anything.
+ *******************************************************************/
+void simulate_stored(){
+  static long long hist_before[POLICIES][LATENCY_BUCKETS];
+  static int64_t values[STORED_FIXED+2*POLICIES*LATENCY_BUCKETS];
+  struct cell_stats *row = seek_time[length-min_length];
+  char text[512], flash[160]="";
+  int k,b,n=0;
+  if(device==&ssd_device){
+    snprintf(flash, sizeof(flash), " channels=%d dies=%d block=%d overprovision=%.17g",ssd_channels,
+             ssd_dies_per_channel,ssd_block_pages,ssd_overprovision);
+  }
+  snprintf(text, sizeof(text), "disk_scheduling/1 device=%s%s queue=%d write=%.17g batches=%d ci=%.17g "
+           "min_runs=%d seed=%llu length=%d",device->name,flash,queue_depth,write_ratio,batches,ci_width,
+           min_runs,(unsigned long long)seed,length);
+  uint64_t key = store_key(text);
+  uint32_t count = 0;
+  const int64_t *cached = store_get(&result_store, key, &count);
+  if(cached!=NULL){
+    if(count>=STORED_FIXED && (count-STORED_FIXED)%2==0){
+      for(k=0;k<POLICIES;k++){
+        const int64_t *v = cached+8*k;
+        row[k].n = v[0];
+        row[k].sum = v[1];
+        row[k].min = v[2];
+        row[k].max = v[3];
+        row[k].sum_sq = (__int128)((unsigned __int128)(uint64_t)v[5]<<64 | (uint64_t)v[4]);
+        busy_time[k] += v[6];
+        served[k] += v[7];
+        reused_requests += v[7];
+      }
+      host_writes += cached[8*POLICIES];
+      gc_writes += cached[8*POLICIES+1];
+      erases += cached[8*POLICIES+2];
+      for(n=STORED_FIXED;n<(int)count;n+=2){
+        if(cached[n]>=0 && cached[n]<POLICIES*LATENCY_BUCKETS){
+          latency_hist[cached[n]/LATENCY_BUCKETS][cached[n]%LATENCY_BUCKETS] += cached[n+1];
+        }
+      }
+      stored_reused++;
+      return;
+    }
+  }
+  prng_seed(&rng, prng_derive(seed, length));
+  prng_x4_seed(&bulk_rng, prng_derive(seed+1, length));
+  prng_seed(&write_rng, prng_derive(seed+2, length));
+  if(device==&ssd_device){
+    ssd_precondition();
+  }
+  memcpy(hist_before, latency_hist, sizeof(hist_before));
+  for(k=0;k<POLICIES;k++){
+    values[8*k+6] = busy_time[k];
+    values[8*k+7] = served[k];
+  }
+  values[8*POLICIES] = host_writes;
+  values[8*POLICIES+1] = gc_writes;
+  values[8*POLICIES+2] = erases;
+  simulate();
+  for(k=0;k<POLICIES;k++){
+    values[8*k] = row[k].n;
+    values[8*k+1] = row[k].sum;
+    values[8*k+2] = row[k].min;
+    values[8*k+3] = row[k].max;
+    values[8*k+4] = (int64_t)(uint64_t)(unsigned __int128)row[k].sum_sq;
+    values[8*k+5] = (int64_t)(uint64_t)((unsigned __int128)row[k].sum_sq>>64);
+    values[8*k+6] = busy_time[k]-values[8*k+6];
+    values[8*k+7] = served[k]-values[8*k+7];
+  }
+  values[8*POLICIES] = host_writes-values[8*POLICIES];
+  values[8*POLICIES+1] = gc_writes-values[8*POLICIES+1];
+  values[8*POLICIES+2] = erases-values[8*POLICIES+2];
+  n = STORED_FIXED;
+  for(k=0;k<POLICIES;k++){
+    for(b=0;b<LATENCY_BUCKETS;b++){
+      if(latency_hist[k][b]!=hist_before[k][b]){
+        values[n++] = k*LATENCY_BUCKETS+b;
+        values[n++] = latency_hist[k][b]-hist_before[k][b];
+      }
+    }
+  }
+  store_put(&result_store, key, values, n);
+  stored_computed++;
+}
+
 /*******************************************************************
  *void print_matrix()
  *Author: Prashant Yadav
  *Date: 11/12/2019
- *Description: It prints final matrix for all seek times
+ *Description: It prints final matrix for all seek times, average of batches in seconds. With
+ *             stats_mode every cell also shows standard deviation, minimum and maximum, with
+ *             ci_width it shows batches the cell needed.
  *Parameters:
  *This method doesn't accept anything.
  *This method doesn't return anything.
  *******************************************************************/
 void print_matrix(){
-  printf("I/O Request\tFIFO\t\tSSTF\t\tSCAN\t\tCSCAN\n");
+  printf("I/O Request\tFIFO\t\tSSTF\t\tSCAN\t\tCSCAN\t\tSATF\n");
+  int i,k;
+  long long runs=0;
+  for(i=0;i<=max_length-min_length;i++){
+    printf("%d",i+min_length);
+    for(k=0;k<POLICIES;k++){
+      struct cell_stats *c = &seek_time[i][k];
+      printf("\t\t%.2f",(double)c->sum/c->n/1e9);   //Average over batches, nanoseconds to seconds
+      if(stats_mode){
+        printf(" sd %.2f [%.2f, %.2f]",cell_stddev(c)/1e9,c->min/1e9,c->max/1e9);
+      }
+      if(ci_width>0){
+        printf(" n %lld",c->n);
+      }
+      runs += c->n;
+    }
+    printf("\n");
+  }
+  if(ci_width>0){
+    printf("Cell batches %lld, %.1f%% of fixed count, target half width %.3g of mean\n",runs,
+           100.0*runs/((double)POLICIES*batches*(max_length-min_length+1)),ci_width);
+  }
+}
+
+/*******************************************************************
+ *double latency_percentile(int policy, double fraction)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns latency below which given fraction of requests of policy completed,
+ *             as upper edge of histogram bucket.
+ *Parameters:
+ *int policy I/P: Scheduling policy.
+ *double fraction I/P: Fraction of requests, e.g. 0.99.
+ *double O/P: It returns latency in milliseconds.
+ *******************************************************************/
+double latency_percentile(int policy, double fraction){
+  long long seen=0;
+  int b;
+  for(b=0;b<LATENCY_BUCKETS;b++){
+    seen += latency_hist[policy][b];
+    if(seen>=fraction*served[policy]){
+      break;
+    }
+  }
+  if(b==0){
+    return 0.001;
+  }
+  return ldexp(1.0+((b-1)%8+1)/8.0, (b-1)/8)/1000.0;
+}
+
+/*******************************************************************
+ *void print_device_stats()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints throughput and latency percentiles of every policy on the device,
+ *             and write amplification of flash. Incremental mode has no latencies. With merging
+ *             it prints share of requests merged away and operation size.
+ *Parameters:
+ *This method doesn't accept anything.
+ *This method doesn't return anything.
+ *******************************************************************/
+void print_device_stats(){
+  const char *names[POLICIES] = {"FIFO","SSTF","SCAN","CSCAN","SATF"};
+  int k;
+  printf("Device %s, queue depth %d, write ratio %.2f\n",device->name,queue_depth,write_ratio);
+  printf("Policy\tIOPS\t\tp50 ms\t\tp99 ms\t\tp99.9 ms\n");
+  for(k=0;k<POLICIES;k++){
+    if(incremental_mode){   //Totals of prefixes only, no request latencies
+      printf("%s\t%.1f\t\tn/a\t\tn/a\t\tn/a\n",names[k],busy_time[k]>0?served[k]*1e9/busy_time[k]:0);
+      continue;
+    }
+    printf("%s\t%.1f\t\t%.3f\t\t%.3f\t\t%.3f\n",names[k],busy_time[k]>0?served[k]*1e9/busy_time[k]:0,
+           latency_percentile(k,0.5),latency_percentile(k,0.99),latency_percentile(k,0.999));
+  }
+  if(merge_mode!=MERGE_NONE){
+    printf("Merge %s: %lld requests in %lld operations, merge rate %.2f%%, %.3f sectors per operation\n",
+           merge_names[merge_mode],merge_requests,merge_operations,
+           merge_requests>0?100.0*(merge_requests-merge_operations)/merge_requests:0,
+           merge_operations>0?(double)merge_sectors/merge_operations:0);
+  }
+  if(device==&ssd_device){
+    printf("Flash: %d channels x %d dies, host writes %lld, GC writes %lld, erases %lld, write amplification %.3f\n",
+           ssd_channels,ssd_dies_per_channel,host_writes,gc_writes,erases,
+           host_writes>0?(double)(host_writes+gc_writes)/host_writes:1.0);
+  }
+}
+
+/*******************************************************************
+ *void parse_arguments(int argc, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It parses command line options.
+ *             --seed N       Seed of random number stream (default current time).
+ *             --min-length N Shortest I/O request queue (default 500).
+ *             --max-length N Longest I/O request queue (default 1000).
+ *             --batches N    Batches of I/O requests for each length (default 1000), upper
+ *                            bound with --ci-width.
+ *             --ci-width R   Stop sampling a cell once 95% confidence interval half width is
+ *                            within R times its mean (default 0, fixed batch count).
+ *             --min-runs N   Fewest batches of a cell with --ci-width (default 10).
+ *             --incremental  Simulate lengths as prefixes of one stream per batch, disk with
+ *                            queue depth 1 only.
+ *             --store FILE   Keep results of every length in FILE, reuse lengths found there.
+ *                            Lengths are seeded from seed and length, flash is preconditioned
+ *                            for each.
+ *             --merge M      Merge requests before scheduling: none (default), contiguous
+ *                            sectors or whole track, disk only.
+ *             --trace FILE   Replay blkparse text or binary block trace instead of random
+ *                            batches.
+ *             --trace-action C   blkparse action taken as arrival (default Q).
+ *             --trace-queue N    Pending requests scheduler holds in replay (default 128).
+ *             --trace-convert OUT    Write trace as binary trace to OUT and exit.
+ *             --sectors-per-track N  Geometry of trace blocks on tracks (default 12000).
+ *             --device D     Storage device: hdd (default) or ssd.
+ *             --queue-depth N    Requests device holds at once (default 1).
+ *             --write-ratio R    Fraction of requests which write (default 0).
+ *             --channels N, --dies N  Flash channels and dies per channel (default 8 and 4).
+ *             --block-pages N    Pages in a flash block (default 256).
+ *             --overprovision R  Spare flash as fraction of logical space (default 0.07).
+ *             --stats        Print standard deviation, minimum and maximum of every cell.
+ *             --bench        Suppress progress output and print operation count.
+ *Parameters:
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments.
+ *This method doesn't return anything.
+ *******************************************************************/
+void parse_arguments(int argc, char *argv[]){
   int i;
-  for(i=0;i<501;i++){
-    seek_time[i][0]/=(1000*1000);
-    seek_time[i][1]/=(1000*1000);
-    seek_time[i][2]/=(1000*1000);
-    seek_time[i][3]/=(1000*1000);
-    printf("%d\t\t%.2f\t\t%.2f\t\t%.2f\t\t%.2f\n",i+500,seek_time[i][0],seek_time[i][1],seek_time[i][2],seek_time[i][3]);
+  seed = (uint64_t)time(0);
+  device = &hdd_device;
+  for(i=1;i<argc;i++){
+    if(strcmp(argv[i],"--seed")==0 && i+1<argc){
+      seed = strtoull(argv[++i], NULL, 0);
+    }else if(strcmp(argv[i],"--min-length")==0 && i+1<argc){
+      min_length = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--max-length")==0 && i+1<argc){
+      max_length = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--batches")==0 && i+1<argc){
+      batches = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--device")==0 && i+1<argc){
+      i++;
+      if(strcmp(argv[i],"hdd")==0){
+        device = &hdd_device;
+      }else if(strcmp(argv[i],"ssd")==0){
+        device = &ssd_device;
+      }else{
+        printf("Unknown device %s\n",argv[i]);
+        exit(1);
+      }
+    }else if(strcmp(argv[i],"--queue-depth")==0 && i+1<argc){
+      queue_depth = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--write-ratio")==0 && i+1<argc){
+      write_ratio = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--channels")==0 && i+1<argc){
+      ssd_channels = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--dies")==0 && i+1<argc){
+      ssd_dies_per_channel = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--block-pages")==0 && i+1<argc){
+      ssd_block_pages = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--overprovision")==0 && i+1<argc){
+      ssd_overprovision = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--ci-width")==0 && i+1<argc){
+      ci_width = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--min-runs")==0 && i+1<argc){
+      min_runs = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--store")==0 && i+1<argc){
+      store_path = argv[++i];
+    }else if(strcmp(argv[i],"--merge")==0 && i+1<argc){
+      i++;
+      for(merge_mode=MERGE_TRACK;merge_mode>=0 && strcmp(argv[i],merge_names[merge_mode])!=0;merge_mode--);
+      if(merge_mode<0){
+        printf("Unknown merge mode %s\n",argv[i]);
+        exit(1);
+      }
+    }else if(strcmp(argv[i],"--trace")==0 && i+1<argc){
+      trace_path = argv[++i];
+    }else if(strcmp(argv[i],"--trace-action")==0 && i+1<argc){
+      trace_action = argv[++i][0];
+    }else if(strcmp(argv[i],"--trace-queue")==0 && i+1<argc){
+      trace_queue = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--trace-convert")==0 && i+1<argc){
+      trace_out = argv[++i];
+    }else if(strcmp(argv[i],"--sectors-per-track")==0 && i+1<argc){
+      sectors_per_track = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--incremental")==0){
+      incremental_mode = 1;
+    }else if(strcmp(argv[i],"--stats")==0){
+      stats_mode = 1;
+    }else if(strcmp(argv[i],"--bench")==0){
+      bench_mode = 1;
+    }else{
+      printf("Usage: %s [--seed N] [--min-length N] [--max-length N] [--batches N]\n"
+             "          [--ci-width R] [--min-runs N] [--store FILE] [--incremental]\n"
+             "          [--merge none|contiguous|track] [--trace FILE] [--trace-action C]\n"
+             "          [--trace-queue N] [--trace-convert OUT] [--sectors-per-track N]\n"
+             "          [--device hdd|ssd] [--queue-depth N] [--write-ratio R] [--channels N]\n"
+             "          [--dies N] [--block-pages N] [--overprovision R] [--stats] [--bench]\n",argv[0]);
+      exit(1);
+    }
+  }
+  if(min_length<1 || max_length<min_length || batches<1){
+    printf("Invalid length range or batch count\n");
+    exit(1);
+  }
+  if(ci_width<0 || min_runs<2){
+    printf("Confidence interval width must not be negative and min runs at least 2\n");
+    exit(1);
+  }
+  if(incremental_mode && (device!=&hdd_device || queue_depth!=1 || ci_width>0 || store_path!=NULL)){
+    printf("--incremental needs disk with queue depth 1, without --ci-width and --store\n");
+    exit(1);
+  }
+  if(merge_mode!=MERGE_NONE && (device!=&hdd_device || incremental_mode || store_path!=NULL)){
+    printf("--merge needs disk, without --incremental and --store\n");
+    exit(1);
+  }
+  if(trace_path!=NULL && (incremental_mode || store_path!=NULL || merge_mode!=MERGE_NONE || ci_width>0)){
+    printf("--trace can not be combined with --incremental, --store, --merge and --ci-width\n");
+    exit(1);
+  }
+  if(trace_queue<1 || sectors_per_track<1 || sectors_per_track>SECTORS){
+    printf("Trace queue must be at least 1 and sectors per track between 1 and %d\n",SECTORS);
+    exit(1);
+  }
+  if(queue_depth<1 || write_ratio<0 || write_ratio>1 || ssd_channels<1 || ssd_dies_per_channel<1 ||
+     ssd_block_pages<1 || ssd_overprovision<0.01){
+    printf("Invalid device parameters\n");
+    exit(1);
   }
 }
 
 /*******************************************************************
- *void main()
+ *void allocate_arrays()
  *Author: Prashant Yadav
- *Date: 11/12/2019
- *Description: This is the main driver method. It simulats process for length from 500 to 1000
+ *Date: 10/19/2026
+ *Description: It allocates request arrays for max_length requests and seek time matrix for
+ *             all lengths. Trace replay needs request arrays for trace_queue requests only.
  *Parameters:
  *This method doesn't accept anything.
  *This method doesn't return anything.
  *******************************************************************/
-void main(){
- for(length=500;length<=1000;length++){
-   printf("Simulating for %d \n",length);
-   simulate();
+void allocate_arrays(){
+  int capacity = trace_path!=NULL?trace_queue:max_length;
+  sectors = (int*)malloc(capacity*sizeof(int));
+  tracks = (int*)malloc(capacity*sizeof(int));
+  sorted_sectors = (int*)malloc(capacity*sizeof(int));
+  sorted_tracks = (int*)malloc(capacity*sizeof(int));
+  random_words = (uint64_t*)malloc((capacity+3)*sizeof(uint64_t));
+  for(request_set_size=16;request_set_size<4*capacity;request_set_size*=2);
+  request_set = (unsigned int*)malloc(request_set_size*sizeof(unsigned int));
+  sorted_ids = (int*)malloc(capacity*sizeof(int));
+  writes = (unsigned char*)malloc(capacity);
+  order = (int*)malloc((capacity+1)*sizeof(int));
+  in_flight = (long long*)malloc(queue_depth*sizeof(long long));
+  transfer = (int*)calloc(capacity, sizeof(int));   //Stay 0 without merging
+  merged = (int*)calloc(capacity, sizeof(int));
+  merge_first = (int*)malloc(capacity*sizeof(int));
+  merge_last = (int*)malloc(capacity*sizeof(int));
+  merge_count = (int*)calloc(capacity, sizeof(int));
+  if(trace_path!=NULL){
+    arrival = (long long*)malloc(capacity*sizeof(long long));
+    free_slots = (int*)malloc(capacity*sizeof(int));
+    by_track = (struct pending_request*)malloc(capacity*sizeof(struct pending_request));
+    by_arrival = (struct pending_request*)malloc(capacity*sizeof(struct pending_request));
+  }
+  seek_time = calloc(max_length-min_length+1, sizeof(*seek_time));
+}
+
+/*******************************************************************
+ *int main(int argc, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 11/12/2019
+ *Description: This is the main driver method. It simulats process for length from 500 to 1000
+ *Parameters:
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments, see parse_arguments.
+ *int O/P: It returns 0 on success.
+ *******************************************************************/
+int main(int argc, char *argv[]){
+ parse_arguments(argc, argv);
+ prng_seed(&rng, seed);   //Seed once, every batch continues the same stream
+ prng_x4_seed(&bulk_rng, seed+1);
+ prng_seed(&write_rng, seed+2);
+ allocate_arrays();
+ if(device==&ssd_device){
+   ssd_init();
+ }
+ if(trace_path!=NULL && trace_out!=NULL){
+   int n = trace_convert(trace_out);
+   if(n<0){
+     printf("Can not convert trace %s to %s\n",trace_path,trace_out);
+     return 1;
+   }
+   printf("Converted %d requests of %s to %s\n",n,trace_path,trace_out);
+   return 0;
+ }
+ if(trace_path!=NULL && trace_open()!=0){
+   printf("Can not open trace %s\n",trace_path);
+   return 1;
+ }
+ printf("Seed %llu\n",(unsigned long long)seed);
+ if(store_path!=NULL && store_open(&result_store, store_path)!=0){
+   printf("Can not open store %s\n",store_path);
+   return 1;
+ }
+ for(length=min_length;length<=max_length && !incremental_mode && trace_path==NULL;length++){
+   if(!bench_mode){
+     printf("Simulating for %d \n",length);
+   }
+   if(store_path!=NULL){
+     simulate_stored();
+   }else{
+     simulate();
+   }
+ }
+ if(incremental_mode){
+   simulate_incremental();
+ }
+ if(trace_path!=NULL){
+   int k;
+   for(k=0;k<POLICIES;k++){
+     replay_trace(k);
+   }
+   printf("Trace %s, %s format, %lld requests, queue %d, %d sectors per track\n",trace_path,
+          trace_binary?"binary":"blkparse",served[0],trace_queue,sectors_per_track);
+ }else{
+   print_matrix();
+ }
+ print_device_stats();
+ if(store_path!=NULL){
+   printf("Store %s: %lld lengths reused, %lld simulated, %lld records loaded\n",store_path,
+          stored_reused,stored_computed,result_store.loaded);
+   store_close(&result_store);
+ }
+ if(bench_mode){
+   long long requests = 0;
+   int k;
+   for(k=0;k<POLICIES;k++){
+     requests += served[k];
+   }
+   printf("ops=%lld\n",requests-reused_requests);   //Requests served by all policies
  }
- print_matrix();
+ return 0;
 }
@@ -0,0 +1,478 @@
+/*******************************************************************
+ *File: bench.c
+ *Author: Prashant Yadav
+ *Description: Benchmark driver for all simulators. It runs each simulator with --bench option,
+ *             measures wall time, maximum resident set size and hardware counters of the
+ *             child process and prints one JSON object per benchmark. Results can be appended
+ *             to a history file and compared with a baseline to track regressions.
+ *Procedure:
+ *open_counter - Opens one perf_event counter for child process.
+ *parse_ops - Reads operation count printed by simulator.
+ *run_once - Runs a simulator once and collects measurements.
+ *json_append - Appends text to a JSON string value, escaping quotes, backslashes and control
+ *              characters.
+ *run_benchmark - Runs a benchmark repeat times and prints median result as JSON.
+ *load_baseline - Loads ops per second of each benchmark from a baseline file.
+ *compare_baseline - Compares result with baseline and reports regression.
+ *run_suite - Runs every benchmark listed in a suite file.
+ *parse_arguments - Parses command line options.
+ *main - Driver main routine from where program starts executing.
+ *******************************************************************/
+#define _GNU_SOURCE
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+#include<time.h>
+#include<unistd.h>
+#include<sys/types.h>
+#include<sys/wait.h>
+#include<sys/time.h>
+#include<sys/resource.h>
+#include<sys/syscall.h>
+#include<linux/perf_event.h>
+
+#ifndef BENCH_VERSION
+#define BENCH_VERSION "unknown"   //Makefile passes git describe output
+#endif
+#define MAX_ARGS 64          //Maximum arguments of one benchmark command
+#define MAX_BASELINE 256     //Maximum benchmarks in a baseline file
+#define COUNTERS 5           //Hardware counters collected for each run
+
+//Hardware counters collected for each run, -1 when counter is not available.
+const char *counter_names[COUNTERS] = {"cycles","instructions","cache_references","cache_misses","branch_misses"};
+const unsigned long long counter_configs[COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+//Measurements of one run of a benchmark.
+struct result{
+  double wall_s;
+  long long ops;
+  long max_rss_kb;
+  long long counters[COUNTERS];
+  int status;
+};
+
+//Ops per second of a benchmark in baseline file.
+struct baseline{
+  char name[64];
+  double ops_per_s;
+};
+
+char bin_dir[1024]=".";      //Directory of simulator executables
+const char *record_file=NULL, *baseline_file=NULL, *suite_file=NULL, *bench_name="custom";
+int repeat=3;                //Runs of each benchmark, median is reported
+double threshold=5.0;        //Allowed drop of ops per second in percent
+struct baseline baselines[MAX_BASELINE];
+int baseline_count=0, regressions=0;
+
+/*******************************************************************
+ *int open_counter(pid_t pid, unsigned long long config)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It opens a hardware counter for child process and threads it creates. Counter
+ *             starts when child calls exec, so driver setup is not counted. Its value is read
+ *             with time enabled and time running, so a multiplexed count can be scaled.
+ *Parameters:
+ *pid_t pid I/P: Child process id.
+ *unsigned long long config I/P: Hardware event.
+ *int O/P: It returns file descriptor of counter or -1 if counter is not available.
+ *******************************************************************/
+int open_counter(pid_t pid, unsigned long long config){
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.enable_on_exec = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return (int)syscall(SYS_perf_event_open, &attr, pid, -1, -1, 0);
+}
+
+/*******************************************************************
+ *long long parse_ops(FILE *out)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It reads output of simulator until end of file and returns value of last line
+ *             starting with ops=.
+ *Parameters:
+ *FILE *out I/P: Standard output of simulator.
+ *long long O/P: Operation count, 0 if simulator did not print it.
+ *******************************************************************/
+long long parse_ops(FILE *out){
+  char line[4096];
+  long long ops=0;
+  while(fgets(line, sizeof(line), out)!=NULL){
+    if(strncmp(line,"ops=",4)==0){
+      ops = atoll(line+4);
+    }
+  }
+  return ops;
+}
+
+/*******************************************************************
+ *void run_once(char *argv[], struct result *r)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It forks simulator, attaches counters before exec, reads its output and waits for
+ *             it to finish. A counter which shared the PMU with others and ran only part of the
+ *             time is scaled by time enabled over time running, as perf stat does, one which
+ *             never ran is not available.
+ *Parameters:
+ *char *argv[] I/P: Command to run, argv[0] is path of simulator.
+ *struct result *r O/P: Measurements of the run.
+ *This routine does not return anything.
+ *******************************************************************/
+void run_once(char *argv[], struct result *r){
+  int out_pipe[2], go_pipe[2], fds[COUNTERS], i, status;
+  struct timespec t0,t1;
+  struct rusage usage;
+  char go='g';
+  if(pipe(out_pipe)!=0 || pipe(go_pipe)!=0){
+    perror("pipe");
+    exit(1);
+  }
+  pid_t pid = fork();
+  if(pid<0){
+    perror("fork");
+    exit(1);
+  }
+  if(pid==0){   //Child waits for counters to be attached before exec.
+    close(out_pipe[0]);
+    close(go_pipe[1]);
+    dup2(out_pipe[1], 1);
+    if(read(go_pipe[0], &go, 1)!=1){
+      _exit(127);
+    }
+    execv(argv[0], argv);
+    perror(argv[0]);
+    _exit(127);
+  }
+  close(out_pipe[1]);
+  close(go_pipe[0]);
+  for(i=0;i<COUNTERS;i++){
+    fds[i] = open_counter(pid, counter_configs[i]);
+  }
+  FILE *out = fdopen(out_pipe[0], "r");
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  if(write(go_pipe[1], &go, 1)!=1){
+    perror("write");
+  }
+  close(go_pipe[1]);
+  r->ops = parse_ops(out);
+  wait4(pid, &status, 0, &usage);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  fclose(out);
+  r->wall_s = (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)/1e9;
+  r->max_rss_kb = usage.ru_maxrss;
+  r->status = WIFEXITED(status)?WEXITSTATUS(status):128+WTERMSIG(status);
+  for(i=0;i<COUNTERS;i++){
+    r->counters[i] = -1;
+    if(fds[i]>=0){
+      uint64_t value[3];   //Count, time enabled, time running
+      if(read(fds[i], value, sizeof(value))==sizeof(value) && value[2]>0){
+        r->counters[i] = value[2]<value[1]?(long long)((double)value[0]*value[1]/value[2]):(long long)value[0];
+      }
+      close(fds[i]);
+    }
+  }
+}
+
+/*******************************************************************
+ *int compare_wall(const void *a, const void *b)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It orders results by wall time for qsort.
+ *Parameters:
+ *const void *a I/P: First result.
+ *const void *b I/P: Second result.
+ *int O/P: Negative, zero or positive as for qsort.
+ *******************************************************************/
+int compare_wall(const void *a, const void *b){
+  double x = ((const struct result*)a)->wall_s, y = ((const struct result*)b)->wall_s;
+  return x<y?-1:(x>y?1:0);
+}
+
+/*******************************************************************
+ *void compare_baseline(const char *name, double ops_per_s)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It prints change of ops per second against baseline and counts a regression if
+ *             it dropped more than threshold percent.
+ *Parameters:
+ *const char *name I/P: Benchmark name.
+ *double ops_per_s I/P: Measured ops per second.
+ *This routine does not return anything.
+ *******************************************************************/
+void compare_baseline(const char *name, double ops_per_s){
+  int i;
+  for(i=baseline_count-1;i>=0;i--){   //Latest entry of a benchmark wins
+    if(strcmp(baselines[i].name, name)==0 && baselines[i].ops_per_s>0){
+      double change = (ops_per_s-baselines[i].ops_per_s)*100.0/baselines[i].ops_per_s;
+      int regressed = change<-threshold;
+      regressions += regressed;
+      fprintf(stderr, "%-24s %14.0f ops/s  baseline %14.0f  change %+7.2f%%%s\n", name, ops_per_s,
+              baselines[i].ops_per_s, change, regressed?"  REGRESSION":"");
+      return;
+    }
+  }
+  fprintf(stderr, "%-24s %14.0f ops/s  no baseline\n", name, ops_per_s);
+}
+
+/*******************************************************************
+ *void json_append(char *out, size_t size, const char *text)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It appends text to out as content of a JSON string. Quote and backslash get a
+ *             backslash, other control characters are written as \u00XX. Text which does not
+ *             fit is cut off at a character, never inside an escape.
+ *Parameters:
+ *char *out I/P: Zero terminated string to append to.
+ *size_t size I/P: Size of out buffer.
+ *const char *text I/P: Text to append.
+ *This routine does not return anything.
+ *******************************************************************/
+void json_append(char *out, size_t size, const char *text){
+  size_t len = strlen(out);
+  for(;*text!='\0';text++){
+    unsigned char c = (unsigned char)*text;
+    char escaped[8];
+    if(c=='"' || c=='\\'){
+      snprintf(escaped, sizeof(escaped), "\\%c", c);
+    }else if(c<0x20){
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+    }else{
+      escaped[0] = c;
+      escaped[1] = '\0';
+    }
+    size_t n = strlen(escaped);
+    if(len+n>=size){
+      break;
+    }
+    memcpy(out+len, escaped, n+1);
+    len += n;
+  }
+}
+
+/*******************************************************************
+ *void run_benchmark(const char *name, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It runs a benchmark repeat times and prints run with median wall time as one line
+ *             of JSON. Line is also appended to record file when it is given.
+ *Parameters:
+ *const char *name I/P: Benchmark name.
+ *char *argv[] I/P: Command to run, argv[0] is path of simulator.
+ *This routine does not return anything.
+ *******************************************************************/
+void run_benchmark(const char *name, char *argv[]){
+  struct result runs[64];
+  char json[8192], command[4096]="", escaped_name[512]="";
+  int i,n = repeat<64?repeat:64, len;
+  for(i=0;i<n;i++){
+    run_once(argv, &runs[i]);
+    if(runs[i].status!=0){
+      fprintf(stderr, "%s exited with status %d\n", name, runs[i].status);
+      regressions++;
+      return;
+    }
+  }
+  qsort(runs, n, sizeof(struct result), compare_wall);
+  struct result *r = &runs[n/2];
+  for(i=0;argv[i]!=NULL;i++){   //Escaped, an argument may hold quotes or backslashes
+    json_append(command, sizeof(command), argv[i]);
+    if(argv[i+1]!=NULL){
+      json_append(command, sizeof(command), " ");
+    }
+  }
+  json_append(escaped_name, sizeof(escaped_name), name);
+  double ops_per_s = r->wall_s>0?r->ops/r->wall_s:0;
+  len = snprintf(json, sizeof(json),
+                 "{\"name\":\"%s\",\"version\":\"%s\",\"timestamp\":%lld,\"command\":\"%s\",\"repeat\":%d,"
+                 "\"wall_s\":%.6f,\"ops\":%lld,\"ops_per_s\":%.1f,\"max_rss_kb\":%ld",
+                 escaped_name, BENCH_VERSION, (long long)time(0), command, n, r->wall_s, r->ops, ops_per_s, r->max_rss_kb);
+  for(i=0;i<COUNTERS;i++){
+    if(r->counters[i]>=0){
+      len += snprintf(json+len, sizeof(json)-len, ",\"%s\":%lld", counter_names[i], r->counters[i]);
+    }else{
+      len += snprintf(json+len, sizeof(json)-len, ",\"%s\":null", counter_names[i]);
+    }
+  }
+  if(r->counters[0]>0 && r->counters[1]>=0){
+    len += snprintf(json+len, sizeof(json)-len, ",\"ipc\":%.3f", (double)r->counters[1]/r->counters[0]);
+  }
+  snprintf(json+len, sizeof(json)-len, "}");
+  printf("%s\n", json);
+  fflush(stdout);
+  if(record_file!=NULL){
+    FILE *f = fopen(record_file, "a");
+    if(f!=NULL){
+      fprintf(f, "%s\n", json);
+      fclose(f);
+    }
+  }
+  if(baseline_file!=NULL){
+    compare_baseline(name, ops_per_s);
+  }
+}
+
+/*******************************************************************
+ *void load_baseline()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It loads name and ops per second of each line of baseline file. Missing file is
+ *             treated as empty baseline.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void load_baseline(){
+  char line[8192];
+  FILE *f = fopen(baseline_file, "r");
+  if(f==NULL){
+    return;
+  }
+  while(fgets(line, sizeof(line), f)!=NULL && baseline_count<MAX_BASELINE){
+    char *name = strstr(line, "\"name\":\"");
+    char *ops = strstr(line, "\"ops_per_s\":");
+    if(name==NULL || ops==NULL){
+      continue;
+    }
+    name += 8;
+    int len = (int)(strchr(name,'"')-name);
+    if(len<=0 || len>=(int)sizeof(baselines[0].name)){
+      continue;
+    }
+    memcpy(baselines[baseline_count].name, name, len);
+    baselines[baseline_count].name[len] = 0;
+    baselines[baseline_count].ops_per_s = atof(ops+12);
+    baseline_count++;
+  }
+  fclose(f);
+}
+
+/*******************************************************************
+ *void run_suite()
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It runs every benchmark in suite file. Each line has benchmark name, simulator
+ *             executable in bin_dir and its arguments. Lines starting with # are comments.
+ *Parameters:
+ *This routine does not take any argument.
+ *This routine does not return anything.
+ *******************************************************************/
+void run_suite(){
+  char line[4096], path[2048];
+  FILE *f = fopen(suite_file, "r");
+  if(f==NULL){
+    perror(suite_file);
+    exit(1);
+  }
+  while(fgets(line, sizeof(line), f)!=NULL){
+    char *args[MAX_ARGS+2];
+    int n=0;
+    char *token = strtok(line, " \t\r\n");
+    if(token==NULL || token[0]=='#'){
+      continue;
+    }
+    char *name = token;
+    while((token=strtok(NULL, " \t\r\n"))!=NULL && n<MAX_ARGS){
+      args[n++] = token;
+    }
+    if(n==0){
+      continue;
+    }
+    snprintf(path, sizeof(path), "%s/%s", bin_dir, args[0]);
+    args[0] = path;
+    args[n++] = "--bench";
+    args[n] = NULL;
+    run_benchmark(name, args);
+  }
+  fclose(f);
+}
+
+/*******************************************************************
+ *int parse_arguments(int argc, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It parses command line options.
+ *             --suite FILE     Run benchmarks listed in FILE.
+ *             --bin-dir DIR    Directory of simulator executables (default directory of bench).
+ *             --repeat N       Runs of each benchmark, median is reported (default 3).
+ *             --record FILE    Append JSON results to FILE.
+ *             --baseline FILE  Compare ops per second with latest results in FILE.
+ *             --threshold PCT  Allowed drop of ops per second (default 5).
+ *             --name NAME      Name of single benchmark given after --.
+ *             -- CMD ARGS      Run single command, it has to print ops=N itself.
+ *Parameters:
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments.
+ *int O/P: It returns index of command after --, or 0 if there is none.
+ *******************************************************************/
+int parse_arguments(int argc, char *argv[]){
+  int i;
+  char *slash = strrchr(argv[0], '/');
+  if(slash!=NULL){
+    snprintf(bin_dir, sizeof(bin_dir), "%.*s", (int)(slash-argv[0]), argv[0]);
+  }
+  for(i=1;i<argc;i++){
+    if(strcmp(argv[i],"--suite")==0 && i+1<argc){
+      suite_file = argv[++i];
+    }else if(strcmp(argv[i],"--bin-dir")==0 && i+1<argc){
+      snprintf(bin_dir, sizeof(bin_dir), "%s", argv[++i]);
+    }else if(strcmp(argv[i],"--repeat")==0 && i+1<argc){
+      repeat = atoi(argv[++i]);
+    }else if(strcmp(argv[i],"--record")==0 && i+1<argc){
+      record_file = argv[++i];
+    }else if(strcmp(argv[i],"--baseline")==0 && i+1<argc){
+      baseline_file = argv[++i];
+    }else if(strcmp(argv[i],"--threshold")==0 && i+1<argc){
+      threshold = atof(argv[++i]);
+    }else if(strcmp(argv[i],"--name")==0 && i+1<argc){
+      bench_name = argv[++i];
+    }else if(strcmp(argv[i],"--")==0 && i+1<argc){
+      return i+1;
+    }else{
+      fprintf(stderr, "Usage: %s [--suite FILE] [--bin-dir DIR] [--repeat N] [--record FILE]\n"
+                      "          [--baseline FILE] [--threshold PCT] [--name NAME] [-- CMD ARGS]\n", argv[0]);
+      exit(1);
+    }
+  }
+  if(repeat<1){
+    repeat=1;
+  }
+  return 0;
+}
+
+/*******************************************************************
+ *int main(int argc, char *argv[])
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: This is driver routine. It runs suite or single command and exits with status 1
+ *             if any benchmark failed or regressed against baseline.
+ *Parameters:
+ *int argc I/P: Number of command line arguments.
+ *char *argv[] I/P: Command line arguments, see parse_arguments.
+ *int O/P: It returns 0 when there is no regression.
+ *******************************************************************/
+int main(int argc, char *argv[]){
+  int command = parse_arguments(argc, argv);
+  if(baseline_file!=NULL){
+    load_baseline();
+  }
+  if(suite_file!=NULL){
+    run_suite();
+  }
+  if(command>0){
+    run_benchmark(bench_name, argv+command);
+  }
+  if(suite_file==NULL && command==0){
+    fprintf(stderr, "Nothing to run, give --suite FILE or -- CMD ARGS\n");
+    return 1;
+  }
+  return regressions>0;
+}
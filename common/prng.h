@@ -0,0 +1,242 @@
+/*******************************************************************
+ *File: prng.h
+ *Author: Prashant Yadav
+ *Description: Seeded random number generator shared by all simulators. It is xoshiro256**
+ *             seeded through splitmix64. Independent streams for threads are split from
+ *             one seed with the jump function, which advances a generator by 2^128 steps.
+ *Procedure:
+ *prng_rotl - Rotates a 64 bit value left.
+ *prng_seed - Seeds generator from a 64 bit seed.
+ *prng_next - Returns next 64 bit random number.
+ *prng_jump - Advances generator by 2^128 numbers.
+ *prng_stream - Seeds generator for given stream number of a seed.
+ *prng_derive - Derives seed of one cell of a sweep from sweep seed.
+ *prng_bounded - Returns random number between 0 and range-1 without rejection loop.
+ *prng_x4_seed - Seeds four interleaved streams used for bulk generation.
+ *prng_x4_fill - Fills a buffer with random numbers from four interleaved streams.
+ *******************************************************************/
+#ifndef PRNG_H
+#define PRNG_H
+#include<stdint.h>
+
+//State of one random number stream.
+struct prng{
+  uint64_t s[4];
+};
+
+//State of four streams stored word by word, so one step of all four streams is a
+//sequence of element wise vector operations.
+struct prng_x4{
+  uint64_t s[4][4];   //s[word][stream]
+};
+
+/*******************************************************************
+ *uint64_t prng_rotl(uint64_t x, int k)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It rotates x left by k bits.
+ *Parameters:
+ *uint64_t x I/P: Value to rotate.
+ *int k I/P: Number of bits.
+ *uint64_t O/P: Rotated value.
+ *******************************************************************/
+static inline uint64_t prng_rotl(uint64_t x, int k){
+  return (x<<k)|(x>>(64-k));
+}
+
+/*******************************************************************
+ *void prng_seed(struct prng *g, uint64_t seed)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It fills generator state from seed with splitmix64, so similar seeds give
+ *             unrelated streams.
+ *Parameters:
+ *struct prng *g I/P: Generator to seed.
+ *uint64_t seed I/P: Seed value.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void prng_seed(struct prng *g, uint64_t seed){
+  int i;
+  for(i=0;i<4;i++){
+    uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+    z = (z^(z>>30))*0xbf58476d1ce4e5b9ULL;
+    z = (z^(z>>27))*0x94d049bb133111ebULL;
+    g->s[i] = z^(z>>31);
+  }
+}
+
+/*******************************************************************
+ *uint64_t prng_next(struct prng *g)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns next random number of the stream.
+ *Parameters:
+ *struct prng *g I/P: Generator.
+ *uint64_t O/P: Uniformly distributed 64 bit value.
+ *******************************************************************/
+static inline uint64_t prng_next(struct prng *g){
+  uint64_t *s = g->s;
+  uint64_t result = prng_rotl(s[1]*5, 7)*9;
+  uint64_t t = s[1]<<17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = prng_rotl(s[3], 45);
+  return result;
+}
+
+/*******************************************************************
+ *void prng_jump(struct prng *g)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It advances generator by 2^128 numbers. Streams which are jump apart never
+ *             overlap in practice, so each thread can own one.
+ *Parameters:
+ *struct prng *g I/P: Generator.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void prng_jump(struct prng *g){
+  static const uint64_t jump[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                  0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+  uint64_t s0=0, s1=0, s2=0, s3=0;
+  int i,b;
+  for(i=0;i<4;i++){
+    for(b=0;b<64;b++){
+      if(jump[i] & (1ULL<<b)){
+        s0 ^= g->s[0];
+        s1 ^= g->s[1];
+        s2 ^= g->s[2];
+        s3 ^= g->s[3];
+      }
+      prng_next(g);
+    }
+  }
+  g->s[0]=s0;
+  g->s[1]=s1;
+  g->s[2]=s2;
+  g->s[3]=s3;
+}
+
+/*******************************************************************
+ *void prng_stream(struct prng *g, uint64_t seed, int stream)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It seeds generator with seed and jumps it to given stream number.
+ *Parameters:
+ *struct prng *g I/P: Generator.
+ *uint64_t seed I/P: Seed shared by all streams.
+ *int stream I/P: Stream number, e.g. thread index.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void prng_stream(struct prng *g, uint64_t seed, int stream){
+  prng_seed(g, seed);
+  while(stream-->0){
+    prng_jump(g);
+  }
+}
+
+/*******************************************************************
+ *uint64_t prng_derive(uint64_t seed, uint64_t cell)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It mixes cell number into seed with splitmix64 finalizer. A cell seeded this way
+ *             gives same result whether or not other cells of sweep ran before it, so cells can
+ *             be cached and resumed one by one.
+ *Parameters:
+ *uint64_t seed I/P: Seed of sweep.
+ *uint64_t cell I/P: Cell number, e.g. experiment or length.
+ *uint64_t O/P: Seed of the cell.
+ *******************************************************************/
+static inline uint64_t prng_derive(uint64_t seed, uint64_t cell){
+  uint64_t z = seed ^ ((cell+1)*0x9e3779b97f4a7c15ULL);
+  z = (z^(z>>30))*0xbf58476d1ce4e5b9ULL;
+  z = (z^(z>>27))*0x94d049bb133111ebULL;
+  return z^(z>>31);
+}
+
+/*******************************************************************
+ *uint32_t prng_bounded(struct prng *g, uint32_t range)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It maps top 32 bits of next number to 0..range-1 by multiply and shift.
+ *             Bias is below range/2^32, which is negligible for simulation ranges.
+ *Parameters:
+ *struct prng *g I/P: Generator.
+ *uint32_t range I/P: Number of possible values.
+ *uint32_t O/P: Random value between 0 and range-1.
+ *******************************************************************/
+static inline uint32_t prng_bounded(struct prng *g, uint32_t range){
+  return (uint32_t)(((prng_next(g)>>32)*(uint64_t)range)>>32);
+}
+
+/*******************************************************************
+ *void prng_x4_seed(struct prng_x4 *g, uint64_t seed)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It seeds four streams of bulk generator, each stream a jump apart.
+ *Parameters:
+ *struct prng_x4 *g I/P: Bulk generator.
+ *uint64_t seed I/P: Seed value.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void prng_x4_seed(struct prng_x4 *g, uint64_t seed){
+  struct prng one;
+  int lane,i;
+  prng_seed(&one, seed);
+  for(lane=0;lane<4;lane++){
+    for(i=0;i<4;i++){
+      g->s[i][lane] = one.s[i];
+    }
+    prng_jump(&one);
+  }
+}
+
+/*******************************************************************
+ *void prng_x4_fill(struct prng_x4 *g, uint64_t *out, int n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It fills out with n random numbers, four at a time. Multiplications by 5 and 9
+ *             are written as shifts and adds so the loop vectorizes without 64 bit multiply.
+ *Parameters:
+ *struct prng_x4 *g I/P: Bulk generator.
+ *uint64_t *out O/P: Buffer to fill.
+ *int n I/P: Number of values to generate.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void prng_x4_fill(struct prng_x4 *g, uint64_t *out, int n){
+  uint64_t s0[4],s1[4],s2[4],s3[4],r[4];
+  int i,lane;
+  for(lane=0;lane<4;lane++){
+    s0[lane]=g->s[0][lane];
+    s1[lane]=g->s[1][lane];
+    s2[lane]=g->s[2][lane];
+    s3[lane]=g->s[3][lane];
+  }
+  for(i=0;i<n;i+=4){
+    for(lane=0;lane<4;lane++){
+      uint64_t x = s1[lane]+(s1[lane]<<2);    //s1*5
+      x = (x<<7)|(x>>57);
+      r[lane] = x+(x<<3);                    //rotl(s1*5,7)*9
+      uint64_t t = s1[lane]<<17;
+      s2[lane] ^= s0[lane];
+      s3[lane] ^= s1[lane];
+      s1[lane] ^= s2[lane];
+      s0[lane] ^= s3[lane];
+      s2[lane] ^= t;
+      s3[lane] = (s3[lane]<<45)|(s3[lane]>>19);
+    }
+    for(lane=0;lane<4 && i+lane<n;lane++){
+      out[i+lane]=r[lane];
+    }
+  }
+  for(lane=0;lane<4;lane++){
+    g->s[0][lane]=s0[lane];
+    g->s[1][lane]=s1[lane];
+    g->s[2][lane]=s2[lane];
+    g->s[3][lane]=s3[lane];
+  }
+}
+
+#endif
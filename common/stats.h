@@ -0,0 +1,107 @@
+/*******************************************************************
+ *File: stats.h
+ *Author: Prashant Yadav
+ *Description: Running statistics shared by all simulators. Mean and variance of a result cell
+ *             are updated one run at a time with Welford's method, so a sweep can stop
+ *             sampling a cell once 95% confidence interval of its mean is narrow enough.
+ *Procedure:
+ *welford_add - Adds one run to running mean and variance.
+ *welford_stddev - Returns sample standard deviation.
+ *student_t95 - Returns two sided 95% quantile of Student t distribution.
+ *ci_half_width - Returns half width of 95% confidence interval of a mean.
+ *ci_converged - Tells whether a cell has enough runs and a narrow enough interval.
+ *******************************************************************/
+#ifndef STATS_H
+#define STATS_H
+#include<math.h>
+
+//Running mean and sum of squared deviations of one result cell.
+struct welford{
+  long long n;
+  double mean, m2;
+};
+
+/*******************************************************************
+ *void welford_add(struct welford *w, double x)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It adds x to running statistics without keeping earlier values.
+ *Parameters:
+ *struct welford *w I/P: Statistics of a cell.
+ *double x I/P: Result of one run.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void welford_add(struct welford *w, double x){
+  double delta = x-w->mean;
+  w->n++;
+  w->mean += delta/w->n;
+  w->m2 += delta*(x-w->mean);
+}
+
+/*******************************************************************
+ *double welford_stddev(const struct welford *w)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns sample standard deviation, 0 before second run.
+ *Parameters:
+ *const struct welford *w I/P: Statistics of a cell.
+ *double O/P: Standard deviation.
+ *******************************************************************/
+static inline double welford_stddev(const struct welford *w){
+  return w->n<2?0:sqrt(w->m2/(w->n-1));
+}
+
+/*******************************************************************
+ *double student_t95(long long df)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns quantile t such that mean lies within t standard errors with 95%
+ *             probability. Exact table up to 30 degrees of freedom, 1.96+2.5/df above, which is
+ *             within 0.002 of exact value.
+ *Parameters:
+ *long long df I/P: Degrees of freedom, runs minus one.
+ *double O/P: Quantile.
+ *******************************************************************/
+static inline double student_t95(long long df){
+  static const double table[31] = {0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+    2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086, 2.080,
+    2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  if(df<1){
+    return INFINITY;
+  }
+  return df<=30?table[df]:1.96+2.5/df;
+}
+
+/*******************************************************************
+ *double ci_half_width(double stddev, long long n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns half width of 95% confidence interval of mean of n runs.
+ *Parameters:
+ *double stddev I/P: Sample standard deviation of runs.
+ *long long n I/P: Number of runs.
+ *double O/P: Half width, infinite before second run.
+ *******************************************************************/
+static inline double ci_half_width(double stddev, long long n){
+  return n<2?INFINITY:student_t95(n-1)*stddev/sqrt((double)n);
+}
+
+/*******************************************************************
+ *int ci_converged(double mean, double half_width, long long n, long long min_runs, double width)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It tells whether a cell may stop sampling: it has at least min_runs runs and
+ *             half width of its confidence interval is at most width times its mean.
+ *Parameters:
+ *double mean I/P: Running mean of cell.
+ *double half_width I/P: Half width of confidence interval.
+ *long long n I/P: Runs of cell.
+ *long long min_runs I/P: Fewest runs before a cell may stop.
+ *double width I/P: Target relative half width, e.g. 0.01 for 1% of mean.
+ *int O/P: It returns 1 when cell has converged.
+ *******************************************************************/
+static inline int ci_converged(double mean, double half_width, long long n, long long min_runs, double width){
+  return n>=min_runs && half_width<=width*fabs(mean);
+}
+
+#endif
@@ -0,0 +1,241 @@
+/*******************************************************************
+ *File: store.h
+ *Author: Prashant Yadav
+ *Description: Append only result store shared by simulators. Each record holds results of one
+ *             cell of a sweep as 64 bit values, keyed by hash of a text naming program,
+ *             parameters, seed and cell. A sweep appends every cell as soon as it is done, so a
+ *             killed sweep resumes from its last cell and a sweep with partly overlapping
+ *             parameters reuses cells already computed. Later record of a key wins.
+ *             Record layout: magic, value count, key, values, checksum of key and values.
+ *             A torn record at end of file is cut off when store is opened.
+ *Procedure:
+ *store_hash - Hashes bytes with FNV-1a, continuing from given hash.
+ *store_key - Returns key of a cell from its text.
+ *store_insert - Puts values of a key into in memory table.
+ *store_open - Loads all records of a file and opens it for appending.
+ *store_get - Returns values of a key or NULL.
+ *store_put - Appends a record and flushes it.
+ *store_close - Closes file and frees table.
+ *******************************************************************/
+#ifndef STORE_H
+#define STORE_H
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+#include<unistd.h>
+
+#define STORE_MAGIC 0x4c4c4543u     //"CELL"
+#define STORE_MAX_VALUES (1<<20)    //Longer count means file is damaged
+
+//Values of one key in memory.
+struct store_entry{
+  uint64_t key;
+  uint32_t count;
+  int64_t *values;          //NULL for an empty slot
+};
+
+//Open store, every record of file is in table, indexed by key with linear probing.
+struct store{
+  FILE *file;
+  struct store_entry *table;
+  int capacity;             //Power of 2
+  int used;
+  long long loaded, hits, puts;
+};
+
+/*******************************************************************
+ *uint64_t store_hash(uint64_t h, const void *data, size_t n)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It hashes n bytes with 64 bit FNV-1a, starting from h.
+ *Parameters:
+ *uint64_t h I/P: Hash so far, 0xcbf29ce484222325 to start.
+ *const void *data I/P: Bytes to hash.
+ *size_t n I/P: Number of bytes.
+ *uint64_t O/P: Hash.
+ *******************************************************************/
+static inline uint64_t store_hash(uint64_t h, const void *data, size_t n){
+  const unsigned char *p = (const unsigned char*)data;
+  size_t i;
+  for(i=0;i<n;i++){
+    h = (h^p[i])*0x100000001b3ULL;
+  }
+  return h;
+}
+
+/*******************************************************************
+ *uint64_t store_key(const char *text)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It returns key of a cell. Text has to name program and every parameter which
+ *             changes result of cell, e.g. "disk_scheduling device=hdd ... seed=1 length=500".
+ *Parameters:
+ *const char *text I/P: Text of key.
+ *uint64_t O/P: Key.
+ *******************************************************************/
+static inline uint64_t store_key(const char *text){
+  return store_hash(0xcbf29ce484222325ULL, text, strlen(text));
+}
+
+/*******************************************************************
+ *void store_insert(struct store *s, uint64_t key, const int64_t *values, uint32_t count)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It copies values of key into table, replacing earlier values of same key.
+ *             Table doubles when it is half full.
+ *Parameters:
+ *struct store *s I/P: Store.
+ *uint64_t key I/P: Key of cell.
+ *const int64_t *values I/P: Values of cell.
+ *uint32_t count I/P: Number of values.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void store_insert(struct store *s, uint64_t key, const int64_t *values, uint32_t count){
+  int i;
+  if(2*(s->used+1)>s->capacity){
+    struct store_entry *old = s->table;
+    int old_capacity = s->capacity;
+    s->capacity = old_capacity?2*old_capacity:1024;
+    s->table = (struct store_entry*)calloc(s->capacity, sizeof(struct store_entry));
+    for(i=0;i<old_capacity;i++){
+      if(old[i].values!=NULL){
+        int j = (int)(old[i].key&(s->capacity-1));
+        while(s->table[j].values!=NULL){
+          j = (j+1)&(s->capacity-1);
+        }
+        s->table[j] = old[i];
+      }
+    }
+    free(old);
+  }
+  i = (int)(key&(s->capacity-1));
+  while(s->table[i].values!=NULL && s->table[i].key!=key){
+    i = (i+1)&(s->capacity-1);
+  }
+  if(s->table[i].values==NULL){
+    s->used++;
+  }
+  free(s->table[i].values);
+  s->table[i].key = key;
+  s->table[i].count = count;
+  s->table[i].values = (int64_t*)malloc((count?count:1)*sizeof(int64_t));
+  memcpy(s->table[i].values, values, count*sizeof(int64_t));
+}
+
+/*******************************************************************
+ *int store_open(struct store *s, const char *path)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It loads every complete record of file into table, cuts off a torn record left
+ *             by a killed run and positions file for appending. Missing file is created.
+ *Parameters:
+ *struct store *s O/P: Store to open.
+ *const char *path I/P: File name.
+ *int O/P: It returns 0 on success and -1 if file can not be opened.
+ *******************************************************************/
+static inline int store_open(struct store *s, const char *path){
+  uint32_t head[2];
+  uint64_t key, checksum;
+  int64_t *values = NULL;
+  long good = 0;
+  memset(s, 0, sizeof(*s));
+  s->file = fopen(path, "r+b");
+  if(s->file==NULL){
+    s->file = fopen(path, "w+b");
+  }
+  if(s->file==NULL){
+    return -1;
+  }
+  while(fread(head, sizeof(head), 1, s->file)==1 && head[0]==STORE_MAGIC && head[1]<=STORE_MAX_VALUES &&
+        fread(&key, sizeof(key), 1, s->file)==1){
+    values = (int64_t*)realloc(values, (head[1]?head[1]:1)*sizeof(int64_t));
+    if(fread(values, sizeof(int64_t), head[1], s->file)!=head[1] ||
+       fread(&checksum, sizeof(checksum), 1, s->file)!=1 ||
+       checksum!=store_hash(store_hash(0xcbf29ce484222325ULL, &key, sizeof(key)), values, head[1]*sizeof(int64_t))){
+      break;
+    }
+    store_insert(s, key, values, head[1]);
+    s->loaded++;
+    good = ftell(s->file);
+  }
+  free(values);
+  fflush(s->file);
+  if(ftruncate(fileno(s->file), good)!=0 || fseek(s->file, good, SEEK_SET)!=0){
+    fclose(s->file);
+    return -1;
+  }
+  return 0;
+}
+
+/*******************************************************************
+ *const int64_t *store_get(struct store *s, uint64_t key, uint32_t *count)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It looks up values of a cell.
+ *Parameters:
+ *struct store *s I/P: Store.
+ *uint64_t key I/P: Key of cell.
+ *uint32_t *count O/P: Number of values of cell.
+ *const int64_t * O/P: Values or NULL if store has no such cell.
+ *******************************************************************/
+static inline const int64_t *store_get(struct store *s, uint64_t key, uint32_t *count){
+  int i;
+  if(s->capacity==0){
+    return NULL;
+  }
+  for(i=(int)(key&(s->capacity-1));s->table[i].values!=NULL;i=(i+1)&(s->capacity-1)){
+    if(s->table[i].key==key){
+      *count = s->table[i].count;
+      s->hits++;
+      return s->table[i].values;
+    }
+  }
+  return NULL;
+}
+
+/*******************************************************************
+ *void store_put(struct store *s, uint64_t key, const int64_t *values, uint32_t count)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It appends values of a cell to file and flushes it, so cell survives if process
+ *             is killed later, and adds them to table.
+ *Parameters:
+ *struct store *s I/P: Store.
+ *uint64_t key I/P: Key of cell.
+ *const int64_t *values I/P: Values of cell.
+ *uint32_t count I/P: Number of values.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void store_put(struct store *s, uint64_t key, const int64_t *values, uint32_t count){
+  uint32_t head[2] = {STORE_MAGIC, count};
+  uint64_t checksum = store_hash(store_hash(0xcbf29ce484222325ULL, &key, sizeof(key)), values, count*sizeof(int64_t));
+  fwrite(head, sizeof(head), 1, s->file);
+  fwrite(&key, sizeof(key), 1, s->file);
+  fwrite(values, sizeof(int64_t), count, s->file);
+  fwrite(&checksum, sizeof(checksum), 1, s->file);
+  fflush(s->file);
+  store_insert(s, key, values, count);
+  s->puts++;
+}
+
+/*******************************************************************
+ *void store_close(struct store *s)
+ *Author: Prashant Yadav
+ *Date: 10/19/2026
+ *Description: It closes store file and frees its table.
+ *Parameters:
+ *struct store *s I/P: Store.
+ *This routine does not return anything.
+ *******************************************************************/
+static inline void store_close(struct store *s){
+  int i;
+  for(i=0;i<s->capacity;i++){
+    free(s->table[i].values);
+  }
+  free(s->table);
+  fclose(s->file);
+  memset(s, 0, sizeof(*s));
+}
+
+#endif